@@ -0,0 +1,83 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifdef BIGINTEGER_HEADER
+#include BIGINTEGER_HEADER
+#else
+#include "../biginteger.h"
+#endif
+
+// Counts calls into the global allocator for arithmetic on small values,
+// which the inline limbs of LimbVector keep off the heap. For the numbers
+// from before inline storage, build against the older header:
+//   g++ -std=c++20 -O2 biginteger_inline.cpp
+//   git show a12c7b4^:biginteger.h > /tmp/heap.h
+//   g++ -std=c++20 -O2 -DBIGINTEGER_HEADER='"/tmp/heap.h"' biginteger_inline.cpp
+
+size_t allocations = 0;
+
+void* operator new(size_t size) {
+  ++allocations;
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+
+template<typename Body>
+void measure(const char* name, size_t iterations, Body body) {
+  size_t before = allocations;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    body(i);
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::printf("%-22s %12.2f %12.1f\n", name,
+              static_cast<double>(allocations - before) / iterations,
+              elapsed.count() / iterations);
+}
+
+int main() {
+  const size_t iterations = 200000;
+  std::printf("%-22s %12s %12s\n", "operation", "allocs/op", "ns/op");
+
+  BigInteger counter = 0;
+  measure("BigInteger ++", iterations, [&](size_t) { ++counter; });
+
+  BigInteger sum = 0;
+  measure("BigInteger +=", iterations, [&](size_t i) {
+    sum += static_cast<int>(i % 1000) - 500;
+  });
+
+  measure("BigInteger *=", iterations, [&](size_t i) {
+    BigInteger product = static_cast<int>(i % 30000) + 1;
+    product *= 123456789;
+    product *= product;
+  });
+
+  measure("BigInteger copy", iterations, [&](size_t) {
+    BigInteger copy = counter;
+    copy -= 1;
+  });
+
+  Rational fraction = 1;
+  measure("Rational *= /= -=", iterations, [&](size_t i) {
+    int small = static_cast<int>(i % 7) + 2;
+    fraction *= Rational(small);
+    fraction /= Rational(small + 1);
+    fraction -= Rational(1) / Rational(small);
+    if (i % 16 == 0) {
+      fraction = 1;
+    }
+  });
+
+  std::printf("checksum %s %s %s\n", counter.toString().c_str(),
+              sum.toString().c_str(), fraction.toString().c_str());
+}
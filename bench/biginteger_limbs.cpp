@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "../biginteger.h"
+
+// Compares the default base-10^9 limbs with the binary-limb mode. Build
+// it twice and compare the tables:
+//   g++ -std=c++20 -O2 biginteger_limbs.cpp
+//   g++ -std=c++20 -O2 -DBIGINTEGER_BINARY_LIMBS biginteger_limbs.cpp
+
+std::string randomDigits(std::mt19937_64& rng, size_t digits) {
+  std::string result(digits, '0');
+  result[0] = static_cast<char>('1' + rng() % 9);
+  for (size_t i = 1; i < digits; ++i) {
+    result[i] = static_cast<char>('0' + rng() % 10);
+  }
+  return result;
+}
+
+template<typename Body>
+double microseconds(Body body) {
+  size_t repeats = 1;
+  while (true) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repeats; ++i) {
+      body();
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (elapsed.count() > 200000) {
+      return elapsed.count() / repeats;
+    }
+    repeats *= 2;
+  }
+}
+
+int main() {
+  std::mt19937_64 rng(1);
+#ifdef BIGINTEGER_BINARY_LIMBS
+  std::printf("binary limbs, us per operation\n");
+#else
+  std::printf("decimal limbs, us per operation\n");
+#endif
+  std::printf("%8s %10s %10s %10s %12s\n", "digits", "add", "multiply",
+              "divide", "toString");
+  for (size_t digits : {300, 3000, 30000}) {
+    BigInteger first(randomDigits(rng, digits));
+    BigInteger second(randomDigits(rng, digits - digits / 30));
+    BigInteger wide = first * first;
+    double add = microseconds([&] {
+      BigInteger sum = first;
+      sum += second;
+    });
+    double multiply = microseconds([&] {
+      BigInteger product = first;
+      product *= second;
+    });
+    double divide = microseconds([&] {
+      BigInteger quotient = wide;
+      quotient /= second;
+    });
+    double print = microseconds([&] { first.toString(); });
+    std::printf("%8zu %10.2f %10.2f %10.2f %12.2f\n", digits, add, multiply,
+                divide, print);
+  }
+
+  // Arithmetic-heavy workload with a single print at the end: 3000!.
+  auto start = std::chrono::steady_clock::now();
+  BigInteger factorial = 1;
+  for (int32_t i = 2; i <= 3000; ++i) {
+    factorial *= i;
+  }
+  std::chrono::duration<double, std::milli> compute =
+      std::chrono::steady_clock::now() - start;
+  std::string text = factorial.toString();
+  std::chrono::duration<double, std::milli> total =
+      std::chrono::steady_clock::now() - start;
+  std::printf("3000! (%zu digits): compute %.2f ms, with toString %.2f ms\n",
+              text.size(), compute.count(), total.count());
+}
@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "../biginteger.h"
+
+// Crossover between the schoolbook, Karatsuba, Toom-3 and NTT
+// multiplication tiers. Each column forces one tier by moving the
+// thresholds around it.
+
+std::string randomDigits(std::mt19937_64& rng, size_t digits) {
+  std::string result(digits, '0');
+  result[0] = static_cast<char>('1' + rng() % 9);
+  for (size_t i = 1; i < digits; ++i) {
+    result[i] = static_cast<char>('0' + rng() % 10);
+  }
+  return result;
+}
+
+template<typename Function>
+double microsecondsPerCall(Function function) {
+  size_t repeats = 1;
+  while (true) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repeats; ++i) {
+      function();
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (elapsed.count() > 200000 || repeats >= (1 << 20)) {
+      return elapsed.count() / repeats;
+    }
+    repeats *= 2;
+  }
+}
+
+double microsecondsPerProduct(const BigInteger& first,
+                              const BigInteger& second) {
+  return microsecondsPerCall([&] {
+    BigInteger product = first;
+    product *= second;
+  });
+}
+
+int main(int argc, char* argv[]) {
+  size_t max_digits = argc > 1 ? std::stoul(argv[1]) : 100000;
+  std::mt19937_64 rng(1);
+
+  const size_t karatsuba = BigInteger::karatsuba_threshold;
+  const size_t toom3 = BigInteger::toom3_threshold;
+  const size_t ntt = BigInteger::ntt_threshold;
+  const size_t kNever = size_t(1) << 40;
+
+  std::printf("%8s %12s %12s %12s %12s   (us per product)\n", "digits",
+              "schoolbook", "karatsuba", "toom-3", "ntt");
+  for (size_t digits = 360; digits <= max_digits; digits *= 2) {
+    BigInteger first(randomDigits(rng, digits));
+    BigInteger second(randomDigits(rng, digits));
+
+    BigInteger::ntt_threshold = kNever;
+    BigInteger::karatsuba_threshold = kNever;
+    double schoolbook = digits <= 25000 ? microsecondsPerProduct(first, second)
+                                        : 0;
+
+    BigInteger::karatsuba_threshold = karatsuba;
+    BigInteger::toom3_threshold = kNever;
+    double karatsuba_time = microsecondsPerProduct(first, second);
+
+    BigInteger::toom3_threshold = karatsuba;
+    double toom3_time = microsecondsPerProduct(first, second);
+    BigInteger::toom3_threshold = toom3;
+
+    BigInteger::ntt_threshold = 0;
+    double ntt_time = microsecondsPerProduct(first, second);
+    BigInteger::ntt_threshold = ntt;
+
+    char schoolbook_text[32] = "-";
+    if (schoolbook > 0) {
+      std::snprintf(schoolbook_text, sizeof(schoolbook_text), "%.1f",
+                    schoolbook);
+    }
+    std::printf("%8zu %12s %12.1f %12.1f %12.1f\n", digits, schoolbook_text,
+                karatsuba_time, toom3_time, ntt_time);
+  }
+}
@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../unordered_map.h"
+
+// FlatUnorderedMap against UnorderedMap and std::unordered_map with random
+// 64-bit keys: millions of operations per second for n inserts, 3n hit
+// finds, n miss finds and n find+erase pairs, plus allocator calls and live
+// bytes per entry once every key is inserted.
+//   g++ -std=c++20 -O2 flat_unordered_map.cpp
+
+size_t allocations = 0;
+size_t live_bytes = 0;
+
+template<typename T>
+struct CountingAllocator {
+  using value_type = T;
+
+  CountingAllocator() = default;
+
+  template<typename U>
+  CountingAllocator(const CountingAllocator<U>&) {}
+
+  T* allocate(size_t count) {
+    ++allocations;
+    live_bytes += count * sizeof(T);
+    return std::allocator<T>().allocate(count);
+  }
+
+  void deallocate(T* pointer, size_t count) {
+    live_bytes -= count * sizeof(T);
+    std::allocator<T>().deallocate(pointer, count);
+  }
+
+  template<typename U>
+  bool operator==(const CountingAllocator<U>&) const {
+    return true;
+  }
+};
+
+using Key = unsigned long long;
+using Allocator = CountingAllocator<std::pair<const Key, Key>>;
+
+class Phase {
+  std::chrono::steady_clock::time_point start_ =
+      std::chrono::steady_clock::now();
+
+ public:
+  double mops(size_t operations) {
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start_;
+    start_ = std::chrono::steady_clock::now();
+    return operations / elapsed.count();
+  }
+};
+
+template<typename Map>
+void run(const char* name, const std::vector<Key>& keys,
+         const std::vector<Key>& misses) {
+  allocations = 0;
+  size_t found = 0;
+  {
+    Map map;
+    Phase phase;
+    for (Key key : keys) {
+      map[key] = key;
+    }
+    double insert = phase.mops(keys.size());
+    size_t calls = allocations;
+    double bytes = static_cast<double>(live_bytes) / keys.size();
+
+    phase = Phase();
+    for (size_t round = 0; round < 3; ++round) {
+      for (Key key : keys) {
+        found += map.find(key)->second == key;
+      }
+    }
+    double hit = phase.mops(3 * keys.size());
+    for (Key key : misses) {
+      found += map.find(key) != map.end();
+    }
+    double miss = phase.mops(misses.size());
+    for (Key key : keys) {
+      map.erase(map.find(key));
+    }
+    double erase = phase.mops(keys.size());
+
+    std::printf("  %-16s %8.1f %8.1f %8.1f %8.1f %10zu %8.1f\n", name, insert,
+                hit, miss, erase, calls, bytes);
+  }
+  if (found != 3 * keys.size()) {
+    std::printf("  %s: wrong lookups\n", name);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  size_t size = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  std::mt19937_64 rng(5);
+  std::vector<Key> keys(size);
+  std::vector<Key> misses(size);
+  for (Key& key : keys) {
+    key = rng() | 1;
+  }
+  for (Key& key : misses) {
+    key = rng() & ~Key(1);
+  }
+
+  std::printf("n=%zu, Mops/s except allocator calls and bytes per entry\n",
+              size);
+  std::printf("  %-16s %8s %8s %8s %8s %10s %8s\n", "", "insert", "find",
+              "miss", "erase", "allocs", "B/entry");
+  run<FlatUnorderedMap<Key, Key, std::hash<Key>, std::equal_to<Key>,
+                       Allocator>>("FlatUnorderedMap", keys, misses);
+  run<UnorderedMap<Key, Key, std::hash<Key>, std::equal_to<Key>,
+                   Allocator>>("UnorderedMap", keys, misses);
+  run<std::unordered_map<Key, Key, std::hash<Key>, std::equal_to<Key>,
+                         Allocator>>("std", keys, misses);
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../matrix.h"
+
+// Blocked GEMM behind Matrix<N, K, double> * Matrix<K, M, double> against
+// the i-k-j loop it replaced, in GFLOP/s.
+//   g++ -std=c++23 -O2 -march=native matrix_multiply.cpp
+
+template<typename Body>
+double seconds(Body body) {
+  size_t repeats = 1;
+  while (true) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repeats; ++i) {
+      body();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (elapsed.count() > 0.5) {
+      return elapsed.count() / repeats;
+    }
+    repeats *= 2;
+  }
+}
+
+template<size_t N>
+void benchMultiply(std::mt19937_64& rng) {
+  std::uniform_real_distribution<double> distribution(-1, 1);
+  Matrix<N, N, double> first;
+  Matrix<N, N, double> second;
+  std::vector<double> first_plain(N * N);
+  std::vector<double> second_plain(N * N);
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      first[i, j] = first_plain[i * N + j] = distribution(rng);
+      second[i, j] = second_plain[i * N + j] = distribution(rng);
+    }
+  }
+
+  std::vector<double> plain(N * N);
+  double loop_time = seconds([&] {
+    std::fill(plain.begin(), plain.end(), 0.0);
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t k = 0; k < N; ++k) {
+        double factor = first_plain[i * N + k];
+        for (size_t j = 0; j < N; ++j) {
+          plain[i * N + j] += factor * second_plain[k * N + j];
+        }
+      }
+    }
+  });
+
+  Matrix<N, N, double> product;
+  double kernel_time = seconds([&] { product = first * second; });
+
+  double max_error = 0;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      max_error =
+          std::max(max_error, std::abs(product[i, j] - plain[i * N + j]));
+    }
+  }
+  double flops = 2.0 * N * N * N;
+  std::printf("%5zu  loop %6.1f  kernel %6.1f GFLOP/s  max error %.1e\n", N,
+              flops / loop_time / 1e9, flops / kernel_time / 1e9, max_error);
+}
+
+int main() {
+  std::mt19937_64 rng(1);
+  benchMultiply<256>(rng);
+  benchMultiply<512>(rng);
+  benchMultiply<1024>(rng);
+}
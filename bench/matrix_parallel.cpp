@@ -0,0 +1,68 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "../matrix.h"
+
+// Matrix kernels run with no pool and with pools of increasing size. The pool
+// is passed to each call; every result must match the sequential one.
+//   g++ -std=c++23 -O2 -pthread matrix_parallel.cpp
+//   ./a.out [max threads]
+
+template<typename Field>
+DynMatrix<Field> randomMatrix(size_t rows, size_t columns, unsigned seed) {
+  std::mt19937 rng(seed);
+  DynMatrix<Field> matrix(rows, columns);
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < columns; ++j) {
+      matrix[i, j] = Field(static_cast<int>(rng() % 2001) - 1000);
+    }
+  }
+  return matrix;
+}
+
+template<typename Body>
+double milliseconds(Body body) {
+  auto start = std::chrono::steady_clock::now();
+  body();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+template<typename Field>
+void bench(const char* name, size_t size, size_t max_threads) {
+  DynMatrix<Field> first = randomMatrix<Field>(size, size, 1);
+  DynMatrix<Field> second = randomMatrix<Field>(size, size, 2);
+  DynMatrix<Field> product = first * second;
+  Field det = first.det();
+  DynMatrix<Field> inverse = first.inverted();
+  std::printf("%s n=%zu\n", name, size);
+  for (size_t threads = 0; threads <= max_threads;
+       threads = threads == 0 ? 1 : threads * 2) {
+    ThreadPool pool(threads == 0 ? 1 : threads);
+    ThreadPool* used = threads == 0 ? nullptr : &pool;
+    bool same = true;
+    double multiply_time = milliseconds(
+        [&] { same = same && multiply(first, second, used) == product; });
+    double det_time =
+        milliseconds([&] { same = same && first.det(used) == det; });
+    double inverse_time =
+        milliseconds([&] { same = same && first.inverted(used) == inverse; });
+    std::printf("  threads %-4s mul %9.1f ms  det %9.1f ms  inv %9.1f ms%s\n",
+                threads == 0 ? "none" : std::to_string(threads).c_str(),
+                multiply_time, det_time, inverse_time,
+                same ? "" : "  MISMATCH");
+  }
+}
+
+int main(int argc, char* argv[]) {
+  size_t max_threads = argc > 1 ? std::stoul(argv[1])
+                                : std::thread::hardware_concurrency();
+  std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+  bench<Residue<1000003>>("Residue<1000003>", 300, max_threads);
+  bench<double>("double", 600, max_threads);
+  bench<Rational>("Rational", 40, max_threads);
+}
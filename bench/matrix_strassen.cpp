@@ -0,0 +1,58 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "../matrix.h"
+
+// Opt-in Strassen-Winograd multiply against the plain loop for exact
+// fields. Both products must be identical.
+//   g++ -std=c++23 -O2 matrix_strassen.cpp
+
+template<typename Body>
+double milliseconds(Body body) {
+  size_t repeats = 1;
+  while (true) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repeats; ++i) {
+      body();
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (elapsed.count() > 300) {
+      return elapsed.count() / repeats;
+    }
+    repeats *= 2;
+  }
+}
+
+template<size_t N, typename Field>
+void benchStrassen(const char* name, std::mt19937_64& rng) {
+  Matrix<N, N, Field> first;
+  Matrix<N, N, Field> second;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      first[i, j] = Field(static_cast<int32_t>(rng() % 2001) - 1000);
+      second[i, j] = Field(static_cast<int32_t>(rng() % 2001) - 1000);
+    }
+  }
+
+  Matrix<N, N, Field> loop_product;
+  double loop_time = milliseconds([&] { loop_product = first * second; });
+
+  Matrix<N, N, Field> strassen_product;
+  double strassen_time = milliseconds(
+      [&] { strassen_product = multiply(first, second, nullptr, 32); });
+
+  std::printf("%-18s %4zu  loop %9.2f ms  strassen %9.2f ms  %s\n", name, N,
+              loop_time, strassen_time,
+              loop_product == strassen_product ? "identical" : "MISMATCH");
+}
+
+int main() {
+  std::mt19937_64 rng(1);
+  benchStrassen<128, Residue<1000003>>("Residue<1000003>", rng);
+  benchStrassen<256, Residue<1000003>>("Residue<1000003>", rng);
+  benchStrassen<512, Residue<1000003>>("Residue<1000003>", rng);
+  benchStrassen<64, Rational>("Rational", rng);
+  benchStrassen<128, Rational>("Rational", rng);
+}
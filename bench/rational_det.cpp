@@ -0,0 +1,64 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "../matrix.h"
+
+// BigInteger::gcd on equal-size random operands and Rational det() on
+// random matrices, the workload the Lehmer gcd was written for.
+//   g++ -std=c++23 -O2 rational_det.cpp
+
+std::string randomDigits(std::mt19937_64& rng, size_t digits) {
+  std::string result(digits, '0');
+  result[0] = static_cast<char>('1' + rng() % 9);
+  for (size_t i = 1; i < digits; ++i) {
+    result[i] = static_cast<char>('0' + rng() % 10);
+  }
+  return result;
+}
+
+template<typename Body>
+double microseconds(Body body) {
+  size_t repeats = 1;
+  while (true) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repeats; ++i) {
+      body();
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (elapsed.count() > 200000) {
+      return elapsed.count() / repeats;
+    }
+    repeats *= 2;
+  }
+}
+
+template<size_t N>
+void benchDet(std::mt19937_64& rng) {
+  Matrix<N, N, Rational> matrix;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      matrix[i, j] = Rational(static_cast<int32_t>(rng() % 199) - 99,
+                              static_cast<int32_t>(rng() % 97) + 1);
+    }
+  }
+  Rational det;
+  double time = microseconds([&] { det = matrix.det(); });
+  std::printf("%2zux%-2zu Rational det: %10.1f us (%zu digits)\n", N, N,
+              time, det.toString().size());
+}
+
+int main() {
+  std::mt19937_64 rng(1);
+  for (size_t digits : {18, 100, 1000, 5000}) {
+    BigInteger first(randomDigits(rng, digits));
+    BigInteger second(randomDigits(rng, digits));
+    double time = microseconds([&] { BigInteger::gcd(first, second); });
+    std::printf("gcd %5zu digits: %10.2f us\n", digits, time);
+  }
+  benchDet<8>(rng);
+  benchDet<12>(rng);
+  benchDet<16>(rng);
+}
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../unordered_map.h"
+
+// Erase/insert churn on a map of fixed size, counting every call into the
+// allocator. With the node pool the churn phase makes no allocator calls.
+//   g++ -std=c++20 -O2 unordered_map_churn.cpp
+
+size_t allocations = 0;
+size_t deallocations = 0;
+size_t live_bytes = 0;
+
+template<typename T>
+struct CountingAllocator {
+  using value_type = T;
+
+  CountingAllocator() = default;
+
+  template<typename U>
+  CountingAllocator(const CountingAllocator<U>&) {}
+
+  T* allocate(size_t count) {
+    ++allocations;
+    live_bytes += count * sizeof(T);
+    return std::allocator<T>().allocate(count);
+  }
+
+  void deallocate(T* pointer, size_t count) {
+    ++deallocations;
+    live_bytes -= count * sizeof(T);
+    std::allocator<T>().deallocate(pointer, count);
+  }
+
+  template<typename U>
+  bool operator==(const CountingAllocator<U>&) const {
+    return true;
+  }
+};
+
+int main(int argc, char* argv[]) {
+  size_t size = argc > 1 ? std::stoul(argv[1]) : 100000;
+  size_t operations = argc > 2 ? std::stoul(argv[2]) : 1000000;
+  std::mt19937_64 rng(9);
+  {
+    UnorderedMap<long long, long long, std::hash<long long>,
+                 std::equal_to<long long>,
+                 CountingAllocator<std::pair<const long long, long long>>> map;
+    map.reserve(2 * size);
+    std::vector<long long> keys(size);
+    for (long long& key : keys) {
+      key = rng();
+      map[key] = 1;
+    }
+
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+      size_t index = rng() % size;
+      map.erase(map.find(keys[index]));
+      keys[index] = rng();
+      map[keys[index]] = i;
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::printf("n=%zu, %zu erase+insert: %.1f ms (%.0f ns/op)\n", size,
+                operations, elapsed.count(),
+                elapsed.count() * 1e6 / operations);
+    std::printf("  allocator calls during churn %zu, total %zu, live %zu KB\n",
+                allocations - before, allocations, live_bytes / 1024);
+    map.clear();
+    std::printf("  after clear: live %zu KB\n", live_bytes / 1024);
+  }
+  std::printf("  after destruction: live %zu B, %zu allocations, "
+              "%zu deallocations\n", live_bytes, allocations, deallocations);
+}
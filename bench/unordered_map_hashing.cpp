@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../unordered_map.h"
+
+// UnorderedMap with string keys: time per phase and how many times the
+// hasher runs. Every operation should hash its key exactly once.
+//   g++ -std=c++20 -O2 unordered_map_hashing.cpp
+
+size_t hash_calls = 0;
+
+struct CountingHash {
+  size_t operator()(const std::string& key) const {
+    ++hash_calls;
+    return std::hash<std::string>{}(key);
+  }
+};
+
+class Phase {
+  std::chrono::steady_clock::time_point start_ =
+      std::chrono::steady_clock::now();
+  size_t calls_ = hash_calls;
+
+ public:
+  void report(const char* name) {
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start_;
+    std::printf("  %-12s %9.1f ms %10zu hashes\n", name, elapsed.count(),
+                hash_calls - calls_);
+    start_ = std::chrono::steady_clock::now();
+    calls_ = hash_calls;
+  }
+};
+
+int main(int argc, char* argv[]) {
+  size_t size = argc > 1 ? std::stoul(argv[1]) : 200000;
+  std::mt19937_64 rng(1);
+  std::vector<std::string> keys(size);
+  for (size_t i = 0; i < size; ++i) {
+    keys[i] = "user/session/" + std::to_string(rng()) + "/payload/" +
+              std::to_string(i);
+  }
+
+  UnorderedMap<std::string, size_t, CountingHash> map;
+  std::printf("n=%zu\n", size);
+  Phase phase;
+  for (size_t i = 0; i < size; ++i) {
+    map.emplace(keys[i], i);
+  }
+  phase.report("emplace");
+
+  size_t sum = 0;
+  for (size_t i = 0; i < 3 * size; ++i) {
+    sum += map.find(keys[rng() % size])->second;
+  }
+  phase.report("find 3n hit");
+
+  size_t missed = 0;
+  for (const std::string& key : keys) {
+    missed += map.find(key + "#") == map.end();
+  }
+  phase.report("find n miss");
+
+  UnorderedMap<std::string, size_t, CountingHash> copy(map);
+  phase.report("copy");
+
+  for (const std::string& key : keys) {
+    map.erase(map.find(key));
+  }
+  phase.report("find+erase");
+
+  std::printf("  left %zu, copy %zu, missed %zu (%zu)\n", map.size(),
+              copy.size(), missed, sum % 7);
+}
@@ -1,43 +1,351 @@
+#ifndef CPP_BIGINTEGER_H
+#define CPP_BIGINTEGER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <deque>
+#include <initializer_list>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <cmath>
 
+class LimbVector {
+  static const uint32_t kInlineSize = 4;
+
+  int64_t* data_ = inline_;
+  uint32_t size_ = 0;
+  uint32_t capacity_ = kInlineSize;
+  int64_t inline_[kInlineSize]{};
+
+  void reserve(size_t capacity);
+
+ public:
+  LimbVector() = default;
+
+  explicit LimbVector(size_t count);
+
+  LimbVector(const int64_t* first, const int64_t* last);
+
+  LimbVector(std::initializer_list<int64_t> limbs);
+
+  LimbVector(const LimbVector& other);
+
+  LimbVector(LimbVector&& other) noexcept;
+
+  LimbVector& operator=(const LimbVector& other);
+
+  LimbVector& operator=(LimbVector&& other) noexcept;
+
+  ~LimbVector();
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  int64_t* data() { return data_; }
+
+  const int64_t* data() const { return data_; }
+
+  int64_t* begin() { return data_; }
+
+  int64_t* end() { return data_ + size_; }
+
+  const int64_t* begin() const { return data_; }
+
+  const int64_t* end() const { return data_ + size_; }
+
+  int64_t& operator[](size_t index) { return data_[index]; }
+
+  const int64_t& operator[](size_t index) const { return data_[index]; }
+
+  int64_t& back() { return data_[size_ - 1]; }
+
+  const int64_t& back() const { return data_[size_ - 1]; }
+
+  void resize(size_t count);
+
+  void push_back(int64_t limb);
+
+  void pop_back() { --size_; }
+
+  void assign(const int64_t* first, const int64_t* last);
+
+  void assign(size_t count, int64_t limb);
+
+  void insert(int64_t* pos, size_t count, int64_t limb);
+
+  bool operator==(const LimbVector& other) const;
+};
+
+LimbVector::LimbVector(size_t count) {
+  resize(count);
+}
+
+LimbVector::LimbVector(const int64_t* first, const int64_t* last) {
+  assign(first, last);
+}
+
+LimbVector::LimbVector(std::initializer_list<int64_t> limbs) {
+  assign(limbs.begin(), limbs.end());
+}
+
+LimbVector::LimbVector(const LimbVector& other) {
+  assign(other.begin(), other.end());
+}
+
+LimbVector::LimbVector(LimbVector&& other) noexcept {
+  *this = std::move(other);
+}
+
+LimbVector& LimbVector::operator=(const LimbVector& other) {
+  if (this != &other) {
+    assign(other.begin(), other.end());
+  }
+  return *this;
+}
+
+LimbVector& LimbVector::operator=(LimbVector&& other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  if (other.data_ == other.inline_) {
+    assign(other.begin(), other.end());
+    other.size_ = 0;
+    return *this;
+  }
+  if (data_ != inline_) {
+    delete[] data_;
+  }
+  data_ = other.data_;
+  size_ = other.size_;
+  capacity_ = other.capacity_;
+  other.data_ = other.inline_;
+  other.size_ = 0;
+  other.capacity_ = kInlineSize;
+  return *this;
+}
+
+LimbVector::~LimbVector() {
+  if (data_ != inline_) {
+    delete[] data_;
+  }
+}
+
+void LimbVector::reserve(size_t capacity) {
+  if (capacity <= capacity_) {
+    return;
+  }
+  capacity = std::max<size_t>(capacity, 2 * capacity_);
+  int64_t* data = new int64_t[capacity];
+  std::copy(data_, data_ + size_, data);
+  if (data_ != inline_) {
+    delete[] data_;
+  }
+  data_ = data;
+  capacity_ = static_cast<uint32_t>(capacity);
+}
+
+void LimbVector::resize(size_t count) {
+  reserve(count);
+  if (count > size_) {
+    std::fill(data_ + size_, data_ + count, 0);
+  }
+  size_ = static_cast<uint32_t>(count);
+}
+
+void LimbVector::push_back(int64_t limb) {
+  reserve(size_ + 1);
+  data_[size_++] = limb;
+}
+
+void LimbVector::assign(const int64_t* first, const int64_t* last) {
+  size_t count = last - first;
+  if (count > capacity_) {
+    LimbVector result;
+    result.reserve(count);
+    std::copy(first, last, result.data_);
+    result.size_ = static_cast<uint32_t>(count);
+    *this = std::move(result);
+    return;
+  }
+  std::copy(first, last, data_);
+  size_ = static_cast<uint32_t>(count);
+}
+
+void LimbVector::assign(size_t count, int64_t limb) {
+  size_ = 0;
+  reserve(count);
+  std::fill(data_, data_ + count, limb);
+  size_ = static_cast<uint32_t>(count);
+}
+
+void LimbVector::insert(int64_t* pos, size_t count, int64_t limb) {
+  size_t index = pos - data_;
+  reserve(size_ + count);
+  std::copy_backward(data_ + index, data_ + size_, data_ + size_ + count);
+  std::fill(data_ + index, data_ + index + count, limb);
+  size_ += static_cast<uint32_t>(count);
+}
+
+bool LimbVector::operator==(const LimbVector& other) const {
+  return std::equal(begin(), end(), other.begin(), other.end());
+}
+
 class BigInteger {
   enum class Sign {
     NON_NEGATIVE = 1,
     NEGATIVE = -1,
   };
 
-  std::vector<int64_t> number;
+  LimbVector number;
   Sign sign = Sign::NON_NEGATIVE;
   static const int32_t kDigits = 9;
-  static const int64_t kBase = 1'000'000'000;
+  static const int64_t kDecimalBase = 1'000'000'000;
+#ifdef BIGINTEGER_BINARY_LIMBS
+  // Full 32-bit limbs: a product of two limbs needs all 64 bits, so the
+  // kernels multiply in uint64_t and accumulate in 128 bits.
+  static const int64_t kBase = int64_t(1) << 32;
+  using WideLimb = __int128;
+#else
+  static const int64_t kBase = kDecimalBase;
+  using WideLimb = int64_t;
+#endif
+
+  static size_t loadThreshold(const std::atomic<size_t>& threshold);
 
   void add(const BigInteger& other);
 
   void subtract(const BigInteger& other);
 
-  static BigInteger multiply(BigInteger num, int64_t factor);
+  static int64_t lowPart(int64_t value);
+
+  static int64_t highPart(int64_t value);
+
+  static void trim(LimbVector& limbs);
+
+  static BigInteger fromLimbs(const int64_t* limbs, size_t size);
+
+  static void addLimbs(LimbVector& dest, const int64_t* src,
+                       size_t size, size_t offset);
+
+  static void subtractLimbs(LimbVector& dest, const int64_t* src,
+                            size_t size);
+
+  static int64_t divideLimbs(LimbVector& limbs, int64_t divisor);
+
+  static LimbVector multiplySchoolbook(const int64_t* first,
+                                       size_t first_size,
+                                       const int64_t* second,
+                                       size_t second_size);
+
+  static LimbVector multiplyKaratsuba(const int64_t* first,
+                                      size_t first_size,
+                                      const int64_t* second,
+                                      size_t second_size);
+
+  static LimbVector multiplyToom3(const int64_t* first,
+                                  size_t first_size,
+                                  const int64_t* second,
+                                  size_t second_size);
+
+  static constexpr uint64_t powMod(uint64_t base, uint64_t exp, uint64_t mod);
+
+  template<uint32_t kModulus>
+  static void transform(std::vector<uint32_t>& values, bool inverse);
+
+  template<uint32_t kModulus>
+  static std::vector<uint32_t> convolve(const int64_t* first,
+                                        size_t first_size,
+                                        const int64_t* second,
+                                        size_t second_size, size_t length);
 
-  BigInteger shiftBit(size_t count) const;
+  static LimbVector multiplyNtt(const int64_t* first,
+                                size_t first_size,
+                                const int64_t* second,
+                                size_t second_size);
 
-  BigInteger shift(size_t count) const;
+  static LimbVector multiplyLimbs(const int64_t* first,
+                                  size_t first_size,
+                                  const int64_t* second,
+                                  size_t second_size);
 
-  size_t length() const;
+  static const BigInteger& decimalPower(size_t level);
+
+  static const BigInteger& decimalReciprocal(size_t level);
+
+  static void multiplyAddLimbs(LimbVector& limbs, int64_t factor,
+                               int64_t addend);
+
+  static BigInteger fromDecimalChunks(const int64_t* chunks, size_t size);
+
+  static void toDecimalChunks(const BigInteger& num, size_t level,
+                              int64_t* chunks);
+
+  LimbVector decimalChunks() const;
+
+  static size_t charsLength(const LimbVector& chunks);
+
+  std::to_chars_result writeChunks(const LimbVector& chunks,
+                                   char* first, char* last) const;
+
+  static std::strong_ordering compareLimbs(const LimbVector& first,
+                                           const LimbVector& second);
+
+  static BigInteger shiftLimbs(const BigInteger& num, size_t count);
+
+  static BigInteger truncateLimbs(const BigInteger& num, size_t count);
+
+  static void divideKnuth(const int64_t* dividend, size_t dividend_size,
+                          const int64_t* divisor, size_t divisor_size,
+                          LimbVector& quotient,
+                          LimbVector& remainder);
+
+  static BigInteger reciprocal(const BigInteger& divisor);
+
+  static void divideNewton(const BigInteger& dividend,
+                           const BigInteger& divisor,
+                           const BigInteger& inverse, BigInteger& quotient,
+                           BigInteger& remainder);
+
+  static void combineLimbs(const LimbVector& first, int64_t first_factor,
+                           const LimbVector& second, int64_t second_factor,
+                           LimbVector& result);
+
+  static void divideMagnitudes(const BigInteger& dividend,
+                               const BigInteger& divisor,
+                               BigInteger& quotient, BigInteger& remainder);
 
  public:
+  // Tuning knobs, in limbs. Atomic so ThreadPool workers can read them
+  // while another thread retunes; any value, including 0, is valid.
+  static inline std::atomic<size_t> karatsuba_threshold = 40;
+  static inline std::atomic<size_t> toom3_threshold = 300;
+  static inline std::atomic<size_t> ntt_threshold = 800;
+  static inline std::atomic<size_t> newton_threshold = 2000;
+  static inline std::atomic<size_t> conversion_threshold = 30;
+  static inline std::atomic<size_t> conversion_newton_threshold = 300;
+
   BigInteger();
 
   BigInteger(int32_t num);
 
-  explicit BigInteger(std::string str);
+  explicit BigInteger(const std::string& str);
 
   bool isZero() const;
   bool isMinusOne() const;
 
   std::string toString() const;
 
+  std::from_chars_result fromChars(const char* first, const char* last);
+
+  std::to_chars_result toChars(char* first, char* last) const;
+
+  size_t limbCount() const;
+
   explicit operator bool() const;
 
   bool operator==(const BigInteger& other) const;
@@ -63,6 +371,8 @@ class BigInteger {
   BigInteger& operator%=(const BigInteger& divisor);
 
   void changeSign();
+
+  static BigInteger gcd(BigInteger first, BigInteger second);
 };
 
 void BigInteger::changeSign() {
@@ -92,43 +402,203 @@ BigInteger::BigInteger(int32_t num) : sign(Sign::NON_NEGATIVE) {
   }
 }
 
-BigInteger::BigInteger(std::string str) : sign(Sign::NON_NEGATIVE) {
-  if (str[0] == '-') {
-    str.erase(str.begin());
-    sign = Sign::NEGATIVE;
+BigInteger::BigInteger(const std::string& str) : BigInteger() {
+  fromChars(str.data(), str.data() + str.size());
+}
+
+std::from_chars_result BigInteger::fromChars(const char* first,
+                                             const char* last) {
+  const char* begin = first;
+  Sign res_sign = Sign::NON_NEGATIVE;
+  if (begin != last && *begin == '-') {
+    ++begin;
+    res_sign = Sign::NEGATIVE;
+  }
+  const char* end = begin;
+  while (end != last && *end >= '0' && *end <= '9') {
+    ++end;
+  }
+  if (end == begin) {
+    return {first, std::errc::invalid_argument};
   }
 
-  int32_t rank = 1;
-  int32_t digit = 0;
-  for (size_t i = str.size(); i-- > 0;) {
-    if (rank == kBase) {
-      number.push_back(digit);
-      digit = 0;
-      rank = 1;
+  LimbVector chunks((end - begin + kDigits - 1) / kDigits);
+  const char* chunk_end = end;
+  for (int64_t& chunk : chunks) {
+    const char* chunk_begin =
+        chunk_end - begin > kDigits ? chunk_end - kDigits : begin;
+    for (const char* digit = chunk_begin; digit != chunk_end; ++digit) {
+      chunk = chunk * 10 + (*digit - '0');
     }
+    chunk_end = chunk_begin;
+  }
 
-    digit += rank * (str[i] - '0');
-    rank *= 10;
+  if (kBase == kDecimalBase) {
+    number = std::move(chunks);
+    trim(number);
+  } else {
+    trim(chunks);
+    number = fromDecimalChunks(chunks.data(), chunks.size()).number;
   }
-  number.push_back(digit);
+  sign = isZero() ? Sign::NON_NEGATIVE : res_sign;
+  return {end, std::errc()};
 }
 
-std::string BigInteger::toString() const {
-  std::string str;
-  if (sign == Sign::NEGATIVE) {
-    str = "-";
+std::to_chars_result BigInteger::toChars(char* first, char* last) const {
+  return writeChunks(decimalChunks(), first, last);
+}
+
+std::to_chars_result BigInteger::writeChunks(
+    const LimbVector& chunks, char* first, char* last) const {
+  size_t size = charsLength(chunks) + (sign == Sign::NEGATIVE ? 1 : 0);
+  if (static_cast<size_t>(last - first) < size) {
+    return {last, std::errc::value_too_large};
   }
-  std::string digit;
-  for (size_t i = number.size(); i-- > 0;) {
-    digit = std::to_string(number[i]);
-    if (i + 1 != number.size()) {
-      digit.insert(0, std::string(kDigits - digit.size(), '0'));
+
+  char* end = first + size;
+  char* pos = end;
+  for (size_t i = 0; i + 1 < chunks.size(); ++i) {
+    int64_t chunk = chunks[i];
+    for (int32_t j = 0; j < kDigits; ++j) {
+      *--pos = static_cast<char>('0' + chunk % 10);
+      chunk /= 10;
     }
-    str += digit;
   }
+  int64_t chunk = chunks.back();
+  do {
+    *--pos = static_cast<char>('0' + chunk % 10);
+    chunk /= 10;
+  } while (chunk != 0);
+  if (sign == Sign::NEGATIVE) {
+    *--pos = '-';
+  }
+  return {end, std::errc()};
+}
+
+std::string BigInteger::toString() const {
+  LimbVector chunks = decimalChunks();
+  std::string str(charsLength(chunks) + (sign == Sign::NEGATIVE ? 1 : 0),
+                  '0');
+  writeChunks(chunks, str.data(), str.data() + str.size());
   return str;
 }
 
+size_t BigInteger::charsLength(const LimbVector& chunks) {
+  size_t length = (chunks.size() - 1) * kDigits + 1;
+  for (int64_t top = chunks.back(); top >= 10; top /= 10) {
+    ++length;
+  }
+  return length;
+}
+
+size_t BigInteger::loadThreshold(const std::atomic<size_t>& threshold) {
+  return threshold.load(std::memory_order_relaxed);
+}
+
+// The caches are shared by every thread. The mutex guards their growth;
+// deque::push_back keeps the returned references valid.
+const BigInteger& BigInteger::decimalPower(size_t level) {
+  static std::deque<BigInteger> powers(1, static_cast<int32_t>(kDecimalBase));
+  static std::mutex mutex;
+  std::lock_guard lock(mutex);
+  while (powers.size() <= level) {
+    BigInteger square = powers.back();
+    square *= powers.back();
+    powers.push_back(std::move(square));
+  }
+  return powers[level];
+}
+
+const BigInteger& BigInteger::decimalReciprocal(size_t level) {
+  static std::deque<BigInteger> reciprocals;
+  static std::mutex mutex;
+  std::lock_guard lock(mutex);
+  while (reciprocals.size() <= level) {
+    reciprocals.push_back(reciprocal(decimalPower(reciprocals.size())));
+  }
+  return reciprocals[level];
+}
+
+void BigInteger::multiplyAddLimbs(LimbVector& limbs, int64_t factor,
+                                  int64_t addend) {
+  int64_t rest = addend;
+  for (int64_t& limb : limbs) {
+    rest += limb * factor;
+    limb = lowPart(rest);
+    rest = highPart(rest);
+  }
+  while (rest != 0) {
+    limbs.push_back(lowPart(rest));
+    rest = highPart(rest);
+  }
+}
+
+BigInteger BigInteger::fromDecimalChunks(const int64_t* chunks, size_t size) {
+  if (size <= std::max<size_t>(loadThreshold(conversion_threshold), 1)) {
+    BigInteger result;
+    for (size_t i = size; i-- > 0;) {
+      multiplyAddLimbs(result.number, kDecimalBase, chunks[i]);
+    }
+    trim(result.number);
+    return result;
+  }
+
+  size_t level = 0;
+  while ((size_t(2) << level) < size) {
+    ++level;
+  }
+  size_t half = size_t(1) << level;
+  BigInteger result = fromDecimalChunks(chunks + half, size - half);
+  result *= decimalPower(level);
+  result += fromDecimalChunks(chunks, half);
+  return result;
+}
+
+void BigInteger::toDecimalChunks(const BigInteger& num, size_t level,
+                                 int64_t* chunks) {
+  size_t size = size_t(1) << level;
+  if (level == 0 ||
+      num.number.size() <=
+          std::max<size_t>(loadThreshold(conversion_threshold), 1)) {
+    LimbVector limbs = num.number;
+    for (size_t i = 0; i < size; ++i) {
+      chunks[i] = divideLimbs(limbs, kDecimalBase);
+    }
+    return;
+  }
+
+  BigInteger quotient;
+  BigInteger remainder;
+  const BigInteger& power = decimalPower(level - 1);
+  if (power.number.size() >= loadThreshold(conversion_newton_threshold)) {
+    divideNewton(num, power, decimalReciprocal(level - 1), quotient,
+                 remainder);
+  } else {
+    divideMagnitudes(num, power, quotient, remainder);
+  }
+  toDecimalChunks(remainder, level - 1, chunks);
+  toDecimalChunks(quotient, level - 1, chunks + size / 2);
+}
+
+LimbVector BigInteger::decimalChunks() const {
+  if (kBase == kDecimalBase) {
+    return number;
+  }
+
+  size_t level = 0;
+  while (compareLimbs(decimalPower(level).number, number) <= 0) {
+    ++level;
+  }
+  LimbVector chunks(size_t(1) << level);
+  toDecimalChunks(*this, level, chunks.data());
+  trim(chunks);
+  return chunks;
+}
+
+size_t BigInteger::limbCount() const {
+  return number.size();
+}
+
 BigInteger::operator bool() const {
   return !(number.empty() || (number.size() == 1 && number[0] == 0));
 }
@@ -197,8 +667,8 @@ void BigInteger::add(const BigInteger& other) {
       break;
     }
 
-    number[i] = rest % kBase;
-    rest /= kBase;
+    number[i] = lowPart(rest);
+    rest = highPart(rest);
     if (i >= other.number.size() && rest == 0) {
       break;
     }
@@ -243,8 +713,8 @@ void BigInteger::subtract(const BigInteger& other) {
       number[i] = kBase + rest;
       rest = -1;
     } else {
-      number[i] = rest % kBase;
-      rest /= kBase;
+      number[i] = lowPart(rest);
+      rest = highPart(rest);
     }
     if (i >= other.number.size() && rest == 0) {
       break;
@@ -283,28 +753,381 @@ BigInteger& BigInteger::operator-=(const BigInteger& other) {
   return *this;
 }
 
-BigInteger BigInteger::multiply(BigInteger num, int64_t factor) {
-  if (factor == 0) {
-    return 0;
+int64_t BigInteger::lowPart(int64_t value) {
+  return static_cast<int64_t>(static_cast<uint64_t>(value) % kBase);
+}
+
+int64_t BigInteger::highPart(int64_t value) {
+  return static_cast<int64_t>(static_cast<uint64_t>(value) / kBase);
+}
+
+void BigInteger::trim(LimbVector& limbs) {
+  while (limbs.size() > 1 && limbs.back() == 0) {
+    limbs.pop_back();
+  }
+  if (limbs.empty()) {
+    limbs.push_back(0);
+  }
+}
+
+BigInteger BigInteger::fromLimbs(const int64_t* limbs, size_t size) {
+  BigInteger result;
+  result.number.assign(limbs, limbs + size);
+  trim(result.number);
+  return result;
+}
+
+void BigInteger::addLimbs(LimbVector& dest, const int64_t* src,
+                          size_t size, size_t offset) {
+  if (dest.size() < offset + size + 1) {
+    dest.resize(offset + size + 1);
+  }
+  int64_t rest = 0;
+  size_t i = 0;
+  for (; i < size; ++i) {
+    rest += dest[offset + i] + src[i];
+    dest[offset + i] = lowPart(rest);
+    rest = highPart(rest);
+  }
+  for (i += offset; rest != 0; ++i) {
+    if (i == dest.size()) {
+      dest.push_back(0);
+    }
+    rest += dest[i];
+    dest[i] = lowPart(rest);
+    rest = highPart(rest);
   }
+}
 
+void BigInteger::subtractLimbs(LimbVector& dest, const int64_t* src,
+                               size_t size) {
   int64_t rest = 0;
-  for (int64_t& bit : num.number) {
-    rest += bit * factor;
-    bit = rest % kBase;
-    rest /= kBase;
+  for (size_t i = 0; i < dest.size() && (i < size || rest != 0); ++i) {
+    rest += dest[i] - (i < size ? src[i] : 0);
+    if (rest < 0) {
+      dest[i] = rest + kBase;
+      rest = -1;
+    } else {
+      dest[i] = rest;
+      rest = 0;
+    }
   }
+}
 
-  if (rest != 0) {
-    num.number.push_back(rest);
+int64_t BigInteger::divideLimbs(LimbVector& limbs, int64_t divisor) {
+  uint64_t rest = 0;
+  for (size_t i = limbs.size(); i-- > 0;) {
+    rest = rest * kBase + limbs[i];
+    limbs[i] = static_cast<int64_t>(rest / divisor);
+    rest %= divisor;
   }
-  return num;
+  trim(limbs);
+  return static_cast<int64_t>(rest);
 }
 
-BigInteger BigInteger::shiftBit(size_t count) const {
-  BigInteger result = *this;
-  std::vector<int64_t> zeros(count);
-  result.number.insert(result.number.begin(), zeros.begin(), zeros.end());
+LimbVector BigInteger::multiplySchoolbook(const int64_t* first,
+                                          size_t first_size,
+                                          const int64_t* second,
+                                          size_t second_size) {
+  LimbVector result(first_size + second_size);
+  if constexpr (kBase != kDecimalBase) {
+    unsigned __int128 column = 0;
+    for (size_t k = 0; k + 1 < result.size(); ++k) {
+      size_t begin = k < second_size ? 0 : k - second_size + 1;
+      size_t end = std::min(k + 1, first_size);
+      for (size_t i = begin; i < end; ++i) {
+        column += static_cast<uint64_t>(first[i]) *
+            static_cast<uint64_t>(second[k - i]);
+      }
+      result[k] = static_cast<int64_t>(column % kBase);
+      column /= kBase;
+    }
+    result.back() = static_cast<int64_t>(column);
+    return result;
+  }
+
+  for (size_t i = 0; i < first_size; ++i) {
+    if (first[i] == 0) {
+      continue;
+    }
+    int64_t rest = 0;
+    for (size_t j = 0; j < second_size; ++j) {
+      rest += result[i + j] + first[i] * second[j];
+      result[i + j] = lowPart(rest);
+      rest = highPart(rest);
+    }
+    result[i + second_size] = rest;
+  }
+  return result;
+}
+
+LimbVector BigInteger::multiplyKaratsuba(const int64_t* first,
+                                         size_t first_size,
+                                         const int64_t* second,
+                                         size_t second_size) {
+  size_t half = (std::max(first_size, second_size) + 1) / 2;
+  size_t first_low = std::min(first_size, half);
+  size_t second_low = std::min(second_size, half);
+
+  LimbVector low =
+      multiplyLimbs(first, first_low, second, second_low);
+  LimbVector high =
+      multiplyLimbs(first + first_low, first_size - first_low,
+                    second + second_low, second_size - second_low);
+
+  LimbVector first_sum(first, first + first_low);
+  addLimbs(first_sum, first + first_low, first_size - first_low, 0);
+  LimbVector second_sum(second, second + second_low);
+  addLimbs(second_sum, second + second_low, second_size - second_low, 0);
+  trim(first_sum);
+  trim(second_sum);
+
+  LimbVector middle =
+      multiplyLimbs(first_sum.data(), first_sum.size(),
+                    second_sum.data(), second_sum.size());
+  subtractLimbs(middle, low.data(), low.size());
+  subtractLimbs(middle, high.data(), high.size());
+  trim(middle);
+
+  LimbVector result(first_size + second_size);
+  addLimbs(result, low.data(), low.size(), 0);
+  addLimbs(result, middle.data(), middle.size(), half);
+  addLimbs(result, high.data(), high.size(), 2 * half);
+  return result;
+}
+
+LimbVector BigInteger::multiplyToom3(const int64_t* first,
+                                     size_t first_size,
+                                     const int64_t* second,
+                                     size_t second_size) {
+  size_t part = (std::max(first_size, second_size) + 2) / 3;
+  auto split = [part](const int64_t* limbs, size_t size) {
+    std::array<BigInteger, 3> parts;
+    for (size_t i = 0; i < 3; ++i) {
+      size_t begin = std::min(size, i * part);
+      size_t end = std::min(size, begin + part);
+      parts[i] = fromLimbs(limbs + begin, end - begin);
+    }
+    return parts;
+  };
+  auto evaluate = [](const std::array<BigInteger, 3>& parts) {
+    std::array<BigInteger, 5> values;
+    BigInteger even = parts[0];
+    even += parts[2];
+    values[0] = parts[0];
+    values[1] = even;
+    values[1] += parts[1];
+    values[2] = even;
+    values[2] -= parts[1];
+    values[3] = values[2];
+    values[3] += parts[2];
+    values[3] *= 2;
+    values[3] -= parts[0];
+    values[4] = parts[2];
+    return values;
+  };
+
+  std::array<BigInteger, 5> first_values = evaluate(split(first, first_size));
+  std::array<BigInteger, 5> second_values =
+      evaluate(split(second, second_size));
+  for (size_t i = 0; i < 5; ++i) {
+    first_values[i] *= second_values[i];
+  }
+
+  BigInteger& r0 = first_values[0];
+  BigInteger& r4 = first_values[4];
+  BigInteger& r3 = first_values[3];
+  r3 -= first_values[1];
+  divideLimbs(r3.number, 3);
+  BigInteger& r1 = first_values[1];
+  r1 -= first_values[2];
+  divideLimbs(r1.number, 2);
+  BigInteger& r2 = first_values[2];
+  r2 -= r0;
+  r3.changeSign();
+  r3 += r2;
+  divideLimbs(r3.number, 2);
+  r3 += r4;
+  r3 += r4;
+  r2 += r1;
+  r2 -= r4;
+  r1 -= r3;
+
+  LimbVector result(first_size + second_size + 1);
+  const std::array<const BigInteger*, 5> coefficients = {&r0, &r1, &r2, &r3,
+                                                         &r4};
+  for (size_t i = 0; i < 5; ++i) {
+    if (!coefficients[i]->isZero()) {
+      addLimbs(result, coefficients[i]->number.data(),
+               coefficients[i]->number.size(), i * part);
+    }
+  }
+  return result;
+}
+
+constexpr uint64_t BigInteger::powMod(uint64_t base, uint64_t exp,
+                                      uint64_t mod) {
+  uint64_t result = 1;
+  base %= mod;
+  while (exp > 0) {
+    if (exp & 1) {
+      result = result * base % mod;
+    }
+    base = base * base % mod;
+    exp >>= 1;
+  }
+  return result;
+}
+
+template<uint32_t kModulus>
+void BigInteger::transform(std::vector<uint32_t>& values, bool inverse) {
+  static constexpr uint64_t kRoot = 3;
+  size_t length = values.size();
+  for (size_t i = 1, j = 0; i < length; ++i) {
+    size_t bit = length >> 1;
+    for (; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      std::swap(values[i], values[j]);
+    }
+  }
+
+  std::vector<uint32_t> roots(length / 2);
+  for (size_t half = 1; half < length; half <<= 1) {
+    uint64_t step = powMod(kRoot, (kModulus - 1) / (2 * half), kModulus);
+    if (inverse) {
+      step = powMod(step, kModulus - 2, kModulus);
+    }
+    roots[0] = 1;
+    for (size_t i = 1; i < half; ++i) {
+      roots[i] = roots[i - 1] * step % kModulus;
+    }
+    for (size_t begin = 0; begin < length; begin += 2 * half) {
+      for (size_t i = 0; i < half; ++i) {
+        uint32_t low = values[begin + i];
+        uint32_t high = static_cast<uint64_t>(values[begin + i + half]) *
+            roots[i] % kModulus;
+        values[begin + i] = low + high < kModulus ? low + high
+                                                  : low + high - kModulus;
+        values[begin + i + half] = low >= high ? low - high
+                                               : low + kModulus - high;
+      }
+    }
+  }
+
+  if (inverse) {
+    uint64_t length_inverse = powMod(length, kModulus - 2, kModulus);
+    for (uint32_t& value : values) {
+      value = value * length_inverse % kModulus;
+    }
+  }
+}
+
+template<uint32_t kModulus>
+std::vector<uint32_t> BigInteger::convolve(const int64_t* first,
+                                           size_t first_size,
+                                           const int64_t* second,
+                                           size_t second_size, size_t length) {
+  std::vector<uint32_t> first_values(length);
+  std::vector<uint32_t> second_values(length);
+  for (size_t i = 0; i < first_size; ++i) {
+    first_values[i] = first[i] % kModulus;
+  }
+  for (size_t i = 0; i < second_size; ++i) {
+    second_values[i] = second[i] % kModulus;
+  }
+  transform<kModulus>(first_values, false);
+  transform<kModulus>(second_values, false);
+  for (size_t i = 0; i < length; ++i) {
+    first_values[i] =
+        static_cast<uint64_t>(first_values[i]) * second_values[i] % kModulus;
+  }
+  transform<kModulus>(first_values, true);
+  return first_values;
+}
+
+LimbVector BigInteger::multiplyNtt(const int64_t* first,
+                                   size_t first_size,
+                                   const int64_t* second,
+                                   size_t second_size) {
+  static constexpr uint64_t kModulus1 = 998'244'353;
+  static constexpr uint64_t kModulus2 = 167'772'161;
+  static constexpr uint64_t kModulus3 = 469'762'049;
+  static constexpr uint64_t kInverse12 =
+      powMod(kModulus1, kModulus2 - 2, kModulus2);
+  static constexpr uint64_t kInverse123 =
+      powMod(kModulus1 * kModulus2 % kModulus3, kModulus3 - 2, kModulus3);
+
+  size_t length = 1;
+  while (length < first_size + second_size) {
+    length <<= 1;
+  }
+  std::vector<uint32_t> residues1 =
+      convolve<kModulus1>(first, first_size, second, second_size, length);
+  std::vector<uint32_t> residues2 =
+      convolve<kModulus2>(first, first_size, second, second_size, length);
+  std::vector<uint32_t> residues3 =
+      convolve<kModulus3>(first, first_size, second, second_size, length);
+
+  LimbVector result(first_size + second_size);
+  unsigned __int128 rest = 0;
+  for (size_t i = 0; i < result.size(); ++i) {
+    uint64_t digit1 = residues1[i];
+    uint64_t digit2 =
+        (residues2[i] + kModulus2 - digit1 % kModulus2) * kInverse12 %
+            kModulus2;
+    uint64_t digit3 =
+        (residues3[i] + 2 * kModulus3 - digit1 % kModulus3 -
+            digit2 * kModulus1 % kModulus3) % kModulus3 * kInverse123 %
+            kModulus3;
+    rest += digit1 + static_cast<unsigned __int128>(digit2) * kModulus1 +
+        static_cast<unsigned __int128>(digit3) * kModulus1 * kModulus2;
+    result[i] = static_cast<int64_t>(rest % kBase);
+    rest /= kBase;
+  }
+  return result;
+}
+
+LimbVector BigInteger::multiplyLimbs(const int64_t* first,
+                                     size_t first_size,
+                                     const int64_t* second,
+                                     size_t second_size) {
+  if (first_size < second_size) {
+    std::swap(first, second);
+    std::swap(first_size, second_size);
+  }
+  if (second_size == 0) {
+    return {0};
+  }
+
+  // Keeps the shorter operand at 2^22 limbs or fewer, so with 32-bit limbs
+  // every coefficient stays below 2^86, under the product of the moduli.
+  static constexpr size_t kMaxNttLength = size_t(1) << 23;
+
+  LimbVector result;
+  if (second_size >= loadThreshold(ntt_threshold) &&
+      first_size + second_size <= kMaxNttLength) {
+    result = multiplyNtt(first, first_size, second, second_size);
+  } else if (second_size <
+             std::max<size_t>(loadThreshold(karatsuba_threshold), 2)) {
+    result = multiplySchoolbook(first, first_size, second, second_size);
+  } else if (2 * second_size <= first_size) {
+    result.resize(first_size + second_size);
+    for (size_t i = 0; i < first_size; i += second_size) {
+      size_t size = std::min(second_size, first_size - i);
+      LimbVector block =
+          multiplyLimbs(first + i, size, second, second_size);
+      trim(block);
+      addLimbs(result, block.data(), block.size(), i);
+    }
+  } else if (second_size < loadThreshold(toom3_threshold)) {
+    result = multiplyKaratsuba(first, first_size, second, second_size);
+  } else {
+    result = multiplyToom3(first, first_size, second, second_size);
+  }
+  trim(result);
   return result;
 }
 
@@ -315,88 +1138,359 @@ BigInteger& BigInteger::operator*=(const BigInteger& other) {
   }
 
   sign = (sign == other.sign ? Sign::NON_NEGATIVE : Sign::NEGATIVE);
-  BigInteger result = 0;
-  for (size_t i = 0; i < other.number.size(); ++i) {
-    result += multiply(*this, other.number[i]).shiftBit(i);
-  }
-  *this = result;
+  number = multiplyLimbs(number.data(), number.size(), other.number.data(),
+                         other.number.size());
   return *this;
 }
 
-BigInteger& BigInteger::operator/=(const BigInteger& divisor) {
-  Sign res_sign = (sign == divisor.sign ? Sign::NON_NEGATIVE : Sign::NEGATIVE);
-  sign = Sign::NON_NEGATIVE;
-  BigInteger div = divisor;
-  div.sign = Sign::NON_NEGATIVE;
-
-  if (*this < div) {
-    *this = 0;
-    return *this;
+std::strong_ordering BigInteger::compareLimbs(
+    const LimbVector& first, const LimbVector& second) {
+  if (first.size() != second.size()) {
+    return first.size() <=> second.size();
   }
-  if (*this == div) {
-    *this = 1;
-    sign = res_sign;
-    return *this;
+  for (size_t i = first.size(); i-- > 0;) {
+    if (first[i] != second[i]) {
+      return first[i] <=> second[i];
+    }
   }
+  return std::strong_ordering::equal;
+}
 
-  size_t len;
-  size_t mod_len = div.length();
-  size_t zero_count;
-  BigInteger shift_mod;
-  BigInteger tmp_mod;
-  BigInteger factor;
+BigInteger BigInteger::shiftLimbs(const BigInteger& num, size_t count) {
+  BigInteger result = num;
+  if (!result.isZero()) {
+    result.number.insert(result.number.begin(), count, 0);
+  }
+  return result;
+}
+
+BigInteger BigInteger::truncateLimbs(const BigInteger& num, size_t count) {
+  if (num.number.size() <= count) {
+    return 0;
+  }
   BigInteger result;
-  while (div <= *this) {
-    len = length();
-    shift_mod = div.shift(len - mod_len);
-    zero_count = len - mod_len;
-    if (*this < shift_mod) {
-      shift_mod = div.shift(len - mod_len - 1);
-      zero_count = len - mod_len - 1;
+  result.number.assign(num.number.begin() + count, num.number.end());
+  result.sign = num.sign;
+  return result;
+}
+
+void BigInteger::divideKnuth(const int64_t* dividend, size_t dividend_size,
+                             const int64_t* divisor, size_t divisor_size,
+                             LimbVector& quotient,
+                             LimbVector& remainder) {
+  size_t n = divisor_size;
+  size_t m = dividend_size - divisor_size;
+  int64_t factor = kBase / (divisor[n - 1] + 1);
+
+  // With 32-bit limbs a limb times factor, the two-limb top and
+  // digit * normalized[i] all need the full unsigned 64 bits.
+  LimbVector current(dividend_size + 1);
+  uint64_t rest = 0;
+  for (size_t i = 0; i < dividend_size; ++i) {
+    rest += static_cast<uint64_t>(dividend[i]) * factor;
+    current[i] = lowPart(rest);
+    rest = highPart(rest);
+  }
+  current[dividend_size] = static_cast<int64_t>(rest);
+
+  LimbVector normalized(n);
+  rest = 0;
+  for (size_t i = 0; i < n; ++i) {
+    rest += static_cast<uint64_t>(divisor[i]) * factor;
+    normalized[i] = lowPart(rest);
+    rest = highPart(rest);
+  }
+
+  const uint64_t base = kBase;
+  quotient.assign(m + 1, 0);
+  for (size_t j = m + 1; j-- > 0;) {
+    uint64_t top = static_cast<uint64_t>(current[j + n]) * base +
+        current[j + n - 1];
+    uint64_t digit = top / normalized[n - 1];
+    uint64_t digit_rest = top % normalized[n - 1];
+    while (digit >= base || (n > 1 && digit * normalized[n - 2] >
+        digit_rest * base + current[j + n - 2])) {
+      --digit;
+      digit_rest += normalized[n - 1];
+      if (digit_rest >= base) {
+        break;
+      }
     }
 
-    factor = 1;
-    tmp_mod = shift_mod;
-    while (tmp_mod < *this) {
-      tmp_mod += shift_mod;
-      ++factor;
+    uint64_t carry = 0;
+    int64_t borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t product = digit * normalized[i] + carry;
+      carry = highPart(product);
+      int64_t diff = current[i + j] - lowPart(product) - borrow;
+      borrow = diff < 0 ? 1 : 0;
+      current[i + j] = diff + borrow * kBase;
+    }
+    current[j + n] -= static_cast<int64_t>(carry) + borrow;
+
+    if (current[j + n] < 0) {
+      --digit;
+      int64_t sum = 0;
+      for (size_t i = 0; i < n; ++i) {
+        sum += current[i + j] + normalized[i];
+        current[i + j] = lowPart(sum);
+        sum = highPart(sum);
+      }
+      current[j + n] += sum;
     }
+    quotient[j] = static_cast<int64_t>(digit);
+  }
+  trim(quotient);
 
-    if (tmp_mod == *this) {
-      result += factor.shift(zero_count);
-      *this = result;
-      sign = res_sign;
-      return *this;
+  current.resize(n);
+  divideLimbs(current, factor);
+  remainder = std::move(current);
+}
+
+BigInteger BigInteger::reciprocal(const BigInteger& divisor) {
+  size_t n = divisor.number.size();
+  size_t high = (n + 3) / 2 + 1;
+  if (n < loadThreshold(newton_threshold) || high >= n) {
+    LimbVector power(2 * n + 1);
+    power.back() = 1;
+    BigInteger result;
+    LimbVector rest;
+    divideKnuth(power.data(), power.size(), divisor.number.data(), n,
+                result.number, rest);
+    return result;
+  }
+
+  BigInteger result =
+      shiftLimbs(reciprocal(truncateLimbs(divisor, n - high)), n - high);
+  BigInteger power = shiftLimbs(1, 2 * n);
+  BigInteger product = divisor;
+  product *= result;
+  BigInteger error = power;
+  error -= product;
+  product = result;
+  product *= error;
+  result += truncateLimbs(product, 2 * n);
+
+  product = divisor;
+  product *= result;
+  error = power;
+  error -= product;
+  BigInteger correction;
+  BigInteger rest;
+  divideMagnitudes(error, divisor, correction, rest);
+  if (error < 0) {
+    result -= correction;
+    if (!rest.isZero()) {
+      --result;
+    }
+  } else {
+    result += correction;
+  }
+  return result;
+}
+
+void BigInteger::divideNewton(const BigInteger& dividend,
+                              const BigInteger& divisor,
+                              const BigInteger& inverse, BigInteger& quotient,
+                              BigInteger& remainder) {
+  size_t n = divisor.number.size();
+  const LimbVector& limbs = dividend.number;
+
+  quotient.number.assign(limbs.size() + 1, 0);
+  remainder = 0;
+  for (size_t begin = (limbs.size() - 1) / n * n;; begin -= n) {
+    size_t end = std::min(limbs.size(), begin + n);
+    BigInteger current = fromLimbs(limbs.data() + begin, end - begin);
+    if (!remainder.isZero()) {
+      addLimbs(current.number, remainder.number.data(),
+               remainder.number.size(), n);
+      trim(current.number);
     }
 
-    tmp_mod -= shift_mod;
-    --factor;
-    result += factor.shift(zero_count);
-    *this -= tmp_mod;
+    BigInteger product = current;
+    product *= inverse;
+    BigInteger digit = truncateLimbs(product, 2 * n);
+    product = digit;
+    product *= divisor;
+    remainder = current;
+    remainder -= product;
+    while (remainder >= divisor) {
+      remainder -= divisor;
+      ++digit;
+    }
+    addLimbs(quotient.number, digit.number.data(), digit.number.size(),
+             begin);
+    if (begin == 0) {
+      break;
+    }
   }
-  *this = result;
-  sign = res_sign;
+  trim(quotient.number);
+}
+
+void BigInteger::divideMagnitudes(const BigInteger& dividend,
+                                  const BigInteger& divisor,
+                                  BigInteger& quotient,
+                                  BigInteger& remainder) {
+  if (compareLimbs(dividend.number, divisor.number) < 0) {
+    remainder = dividend;
+    remainder.sign = Sign::NON_NEGATIVE;
+    quotient = 0;
+    return;
+  }
+
+  size_t dividend_size = dividend.number.size();
+  size_t divisor_size = divisor.number.size();
+  if (divisor_size == 1) {
+    quotient.number = dividend.number;
+    int64_t rest = divideLimbs(quotient.number, divisor.number[0]);
+    remainder = fromLimbs(&rest, 1);
+  } else if (divisor_size >= loadThreshold(newton_threshold) &&
+      dividend_size - divisor_size >= loadThreshold(newton_threshold)) {
+    BigInteger positive_divisor = divisor;
+    positive_divisor.sign = Sign::NON_NEGATIVE;
+    divideNewton(dividend, positive_divisor, reciprocal(positive_divisor),
+                 quotient, remainder);
+  } else {
+    divideKnuth(dividend.number.data(), dividend_size, divisor.number.data(),
+                divisor_size, quotient.number, remainder.number);
+    trim(remainder.number);
+  }
+  quotient.sign = Sign::NON_NEGATIVE;
+  remainder.sign = Sign::NON_NEGATIVE;
+}
+
+BigInteger& BigInteger::operator/=(const BigInteger& divisor) {
+  BigInteger quotient;
+  BigInteger remainder;
+  divideMagnitudes(*this, divisor, quotient, remainder);
+  if (!quotient.isZero() && sign != divisor.sign) {
+    quotient.sign = Sign::NEGATIVE;
+  }
+  *this = std::move(quotient);
   return *this;
 }
 
 BigInteger& BigInteger::operator%=(const BigInteger& divisor) {
-  BigInteger dividend = *this;
-  dividend /= divisor;
-  dividend *= divisor;
-  *this -= dividend;
+  BigInteger quotient;
+  BigInteger remainder;
+  divideMagnitudes(*this, divisor, quotient, remainder);
+  if (!remainder.isZero()) {
+    remainder.sign = sign;
+  }
+  *this = std::move(remainder);
   return *this;
 }
 
-size_t BigInteger::length() const {
-  return (number.size() - 1) * kDigits +
-      std::to_string(number.back()).size();
+void BigInteger::combineLimbs(const LimbVector& first, int64_t first_factor,
+                              const LimbVector& second,
+                              int64_t second_factor, LimbVector& result) {
+  result.resize(first.size());
+  WideLimb rest = 0;
+  for (size_t i = 0; i < first.size(); ++i) {
+    rest += static_cast<WideLimb>(first_factor) * first[i];
+    if (i < second.size()) {
+      rest += static_cast<WideLimb>(second_factor) * second[i];
+    }
+    int64_t limb = static_cast<int64_t>(rest % kBase);
+    rest /= kBase;
+    if (limb < 0) {
+      limb += kBase;
+      --rest;
+    }
+    result[i] = limb;
+  }
+  trim(result);
 }
 
-BigInteger BigInteger::shift(size_t count) const {
-  BigInteger result = *this;
-  result *= BigInteger("1" + std::string(count % kDigits, '0'));
-  std::vector<int64_t> zeros(count / kDigits);
-  result.number.insert(result.number.begin(), zeros.begin(), zeros.end());
+BigInteger BigInteger::gcd(BigInteger first, BigInteger second) {
+  static const int64_t kCofactorLimit = int64_t(1) << 31;
+  // Two 32-bit limbs fill 64 bits; dropping the low four keeps the tops and
+  // the cofactor sums below 2^63. The quotient test holds for any shift.
+  static const int kTopShift = kBase == kDecimalBase ? 0 : 4;
+
+  first.sign = Sign::NON_NEGATIVE;
+  second.sign = Sign::NON_NEGATIVE;
+  if (compareLimbs(first.number, second.number) < 0) {
+    std::swap(first, second);
+  }
+
+  BigInteger quotient;
+  BigInteger remainder;
+  LimbVector first_limbs;
+  LimbVector second_limbs;
+  while (second.number.size() > 2) {
+    size_t size = first.number.size();
+    uint64_t first_leading =
+        static_cast<uint64_t>(first.number[size - 1]) * kBase +
+        first.number[size - 2];
+    uint64_t second_leading = 0;
+    if (second.number.size() == size) {
+      second_leading = static_cast<uint64_t>(second.number[size - 1]) * kBase;
+    }
+    if (second.number.size() + 1 >= size) {
+      second_leading += second.number[size - 2];
+    }
+    int64_t first_top = static_cast<int64_t>(first_leading >> kTopShift);
+    int64_t second_top = static_cast<int64_t>(second_leading >> kTopShift);
+
+    int64_t a = 1;
+    int64_t b = 0;
+    int64_t c = 0;
+    int64_t d = 1;
+    while (second_top + c != 0 && second_top + d != 0) {
+      int64_t factor = (first_top + a) / (second_top + c);
+      if (factor != (first_top + b) / (second_top + d) ||
+          factor >= kCofactorLimit) {
+        break;
+      }
+      int64_t next_c = a - factor * c;
+      int64_t next_d = b - factor * d;
+      if (std::abs(next_c) >= kCofactorLimit ||
+          std::abs(next_d) >= kCofactorLimit) {
+        break;
+      }
+      a = c;
+      c = next_c;
+      b = d;
+      d = next_d;
+      int64_t next_top = first_top - factor * second_top;
+      first_top = second_top;
+      second_top = next_top;
+    }
+
+    if (b == 0) {
+      divideMagnitudes(first, second, quotient, remainder);
+      std::swap(first, second);
+      std::swap(second, remainder);
+      continue;
+    }
+    combineLimbs(first.number, a, second.number, b, first_limbs);
+    combineLimbs(first.number, c, second.number, d, second_limbs);
+    std::swap(first.number, first_limbs);
+    std::swap(second.number, second_limbs);
+  }
+
+  if (second.isZero()) {
+    return first;
+  }
+  divideMagnitudes(first, second, quotient, remainder);
+  uint64_t first_value = second.number[0] +
+      (second.number.size() > 1
+           ? static_cast<uint64_t>(second.number[1]) * kBase : 0);
+  uint64_t second_value = remainder.number[0] +
+      (remainder.number.size() > 1
+           ? static_cast<uint64_t>(remainder.number[1]) * kBase : 0);
+  while (second_value != 0) {
+    first_value %= second_value;
+    std::swap(first_value, second_value);
+  }
+
+  BigInteger result;
+  result.number.resize(0);
+  for (; first_value > 0; first_value /= kBase) {
+    result.number.push_back(first_value % kBase);
+  }
+  trim(result.number);
   return result;
 }
 
@@ -472,10 +1566,12 @@ class Rational {
 
   BigInteger denominator;
 
-  static BigInteger gcd(BigInteger first, BigInteger second);
+  size_t reduction_threshold_ = 0;
 
   void reduce();
 
+  void normalize(const Rational& other);
+
  public:
   Rational();
 
@@ -493,6 +1589,14 @@ class Rational {
 
   explicit operator double() const;
 
+  const BigInteger& getNumerator() const;
+
+  const BigInteger& getDenominator() const;
+
+  size_t reductionThreshold() const;
+
+  void setReductionThreshold(size_t threshold);
+
   bool operator==(const Rational& other) const;
 
   std::strong_ordering operator<=>(const Rational& other) const;
@@ -513,9 +1617,25 @@ void Rational::reduce() {
     numerator.changeSign();
     denominator.changeSign();
   }
-  BigInteger gcd_num = gcd(numerator, denominator);
-  numerator /= gcd_num;
-  denominator /= gcd_num;
+  BigInteger gcd_num = BigInteger::gcd(numerator, denominator);
+  if (gcd_num != 1) {
+    numerator /= gcd_num;
+    denominator /= gcd_num;
+  }
+}
+
+void Rational::normalize(const Rational& other) {
+  reduction_threshold_ =
+      std::max(reduction_threshold_, other.reduction_threshold_);
+  if (reduction_threshold_ == 0 ||
+      numerator.limbCount() + denominator.limbCount() > reduction_threshold_) {
+    reduce();
+    return;
+  }
+  if (denominator < 0) {
+    numerator.changeSign();
+    denominator.changeSign();
+  }
 }
 
 Rational::Rational(BigInteger num, BigInteger denom)
@@ -539,6 +1659,15 @@ Rational::Rational(int32_t num) : numerator(num), denominator(1) {
 }
 
 std::string Rational::toString() const {
+  if (reduction_threshold_ != 0) {
+    Rational reduced(*this);
+    reduced.reduce();
+    std::string result = reduced.numerator.toString();
+    if (reduced.denominator != 1) {
+      result += "/" + reduced.denominator.toString();
+    }
+    return result;
+  }
   std::string result = numerator.toString();
   if (denominator != 1) {
     result += "/" + denominator.toString();
@@ -574,8 +1703,33 @@ Rational::operator double() const {
   return std::stod(asDecimal(15));
 }
 
+const BigInteger& Rational::getNumerator() const {
+  return numerator;
+}
+
+const BigInteger& Rational::getDenominator() const {
+  return denominator;
+}
+
+size_t Rational::reductionThreshold() const {
+  return reduction_threshold_;
+}
+
+void Rational::setReductionThreshold(size_t threshold) {
+  reduction_threshold_ = threshold;
+  if (reduction_threshold_ == 0) {
+    reduce();
+  }
+}
+
 bool Rational::operator==(const Rational& other) const {
-  return numerator == other.numerator && denominator == other.denominator;
+  if (denominator == other.denominator) {
+    return numerator == other.numerator;
+  }
+  if (numerator == 0 || other.numerator == 0) {
+    return numerator == other.numerator;
+  }
+  return numerator * other.denominator == other.numerator * denominator;
 }
 
 std::strong_ordering Rational::operator<=>(const Rational& other) const {
@@ -583,11 +1737,20 @@ std::strong_ordering Rational::operator<=>(const Rational& other) const {
 }
 
 Rational& Rational::operator+=(const Rational& other) {
-  BigInteger gcd_num = gcd(denominator, other.denominator);
-  BigInteger left_factor = other.denominator / gcd_num;
-  BigInteger right_factor = denominator / gcd_num;
-  numerator = numerator * left_factor + other.numerator * right_factor;
-  denominator = denominator * left_factor;
+  if (denominator == other.denominator) {
+    numerator += other.numerator;
+  } else if (reduction_threshold_ != 0 || other.reduction_threshold_ != 0) {
+    numerator *= other.denominator;
+    numerator += other.numerator * denominator;
+    denominator *= other.denominator;
+  } else {
+    BigInteger gcd_num = BigInteger::gcd(denominator, other.denominator);
+    BigInteger left_factor = other.denominator / gcd_num;
+    BigInteger right_factor = denominator / gcd_num;
+    numerator = numerator * left_factor + other.numerator * right_factor;
+    denominator = denominator * left_factor;
+  }
+  normalize(other);
   return *this;
 }
 
@@ -601,14 +1764,14 @@ Rational& Rational::operator-=(const Rational& other) {
 Rational& Rational::operator*=(const Rational& other) {
   numerator *= other.numerator;
   denominator *= other.denominator;
-  reduce();
+  normalize(other);
   return *this;
 }
 
 Rational& Rational::operator/=(const Rational& other) {
   numerator *= other.denominator;
   denominator *= other.numerator;
-  reduce();
+  normalize(other);
   return *this;
 }
 
@@ -642,19 +1805,11 @@ Rational operator/(const Rational& num1, const Rational& num2) {
   return result;
 }
 
-BigInteger Rational::gcd(BigInteger first, BigInteger second) {
-  if (first < 0) {
-    first.changeSign();
-  }
-  if (second < 0) {
-    second.changeSign();
-  }
-  BigInteger tmp;
-  while (second != 0) {
-    first %= second;
-    tmp = second;
-    second = first;
-    first = tmp;
-  }
-  return first;
+std::istream& operator>>(std::istream& is, Rational& num) {
+  int32_t int_num;
+  is >> int_num;
+  num = int_num;
+  return is;
 }
+
+#endif //CPP_BIGINTEGER_H
@@ -1,843 +1,1251 @@
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 #define CPP23 1
 
-class BigInteger {
-  enum class Sign {
-    NON_NEGATIVE = 1,
-    NEGATIVE = -1,
-  };
-
-  std::vector<int64_t> number;
-  Sign sign = Sign::NON_NEGATIVE;
-  static const int32_t kDigits = 9;
-  static const int64_t kBase = 1'000'000'000;
-
-  void add(const BigInteger& other);
-
-  void subtract(const BigInteger& other);
+#include "biginteger.h"
 
-  static BigInteger multiply(BigInteger num, int64_t factor);
-
-  BigInteger shiftBit(size_t count) const;
+constexpr uint64_t mulMod(uint64_t first, uint64_t second, uint64_t modulus) {
+  return static_cast<unsigned __int128>(first) * second % modulus;
+}
 
-  size_t length() const;
+constexpr bool isPrime(uint64_t number) {
+  const uint64_t witnesses[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+  if (number < 2) {
+    return false;
+  }
+  for (uint64_t witness : witnesses) {
+    if (number % witness == 0) {
+      return number == witness;
+    }
+  }
 
-  BigInteger shift(size_t count) const;
+  uint64_t odd = number - 1;
+  int shift = 0;
+  while (odd % 2 == 0) {
+    odd /= 2;
+    ++shift;
+  }
+  for (uint64_t witness : witnesses) {
+    uint64_t value = 1;
+    for (uint64_t exp = odd; exp != 0; exp /= 2) {
+      if (exp % 2 != 0) {
+        value = mulMod(value, witness, number);
+      }
+      witness = mulMod(witness, witness, number);
+    }
+    if (value == 1 || value == number - 1) {
+      continue;
+    }
+    bool passed = false;
+    for (int i = 1; i < shift && !passed; ++i) {
+      value = mulMod(value, value, number);
+      passed = value == number - 1;
+    }
+    if (!passed) {
+      return false;
+    }
+  }
+  return true;
+}
 
-  bool isZero() const;
+constexpr uint64_t montgomeryInverse(uint64_t modulus) {
+  uint64_t inverse = modulus;
+  for (int i = 0; i < 5; ++i) {
+    inverse *= 2 - modulus * inverse;
+  }
+  return -inverse;
+}
 
-  bool isMinusOne() const;
+template<size_t N>
+class Residue {
+  static_assert(N < (uint64_t(1) << 63));
 
-  static Sign invertSign(Sign sign);
+  static constexpr bool kMontgomery =
+      N % 2 == 1 && N > (uint64_t(1) << 32);
+  static constexpr uint64_t kInverse = montgomeryInverse(N);
+  static constexpr uint64_t kUnit = -static_cast<uint64_t>(N) % N;
+  static constexpr uint64_t kSquare =
+      static_cast<unsigned __int128>(kUnit) * kUnit % N;
 
- public:
-  BigInteger();
+  uint64_t num_;
 
-  BigInteger(int32_t num);
+  static uint64_t reduce(unsigned __int128 value);
 
-  explicit BigInteger(std::string str);
+  static uint64_t multiply(uint64_t first, uint64_t second);
 
-  std::string toString() const;
+  static uint64_t toForm(uint64_t value);
 
-  explicit operator bool() const;
+  static uint64_t fromForm(uint64_t value);
 
-  bool operator==(const BigInteger& other) const;
+ public:
+  Residue() = default;
 
-  std::strong_ordering operator<=>(const BigInteger& other) const;
+  Residue(int num);
 
-  BigInteger& operator++();
+  uint64_t value() const;
 
-  BigInteger& operator--();
+  explicit operator int() const;
 
-  BigInteger operator++(int32_t);
+  static Residue<N> pow(Residue<N> number, uint64_t exp);
 
-  BigInteger operator--(int32_t);
+  Residue<N> inverse() const;
 
-  BigInteger& operator+=(const BigInteger& other);
+  static void batchInvert(std::vector<Residue<N>>& values);
 
-  BigInteger& operator-=(const BigInteger& other);
+  bool operator==(const Residue<N>& other) const;
 
-  BigInteger& operator*=(const BigInteger& other);
+  Residue<N>& operator+=(const Residue<N>& other);
 
-  BigInteger& operator/=(const BigInteger& divisor);
+  Residue<N>& operator-=(const Residue<N>& other);
 
-  BigInteger& operator%=(const BigInteger& divisor);
+  Residue<N>& operator*=(const Residue<N>& other);
 
-  void changeSign();
+  Residue<N>& operator/=(const Residue<N>& other);
 };
 
-BigInteger::Sign BigInteger::invertSign(BigInteger::Sign sign) {
-  return sign == Sign::NON_NEGATIVE ? Sign::NEGATIVE : Sign::NON_NEGATIVE;
+template<size_t N>
+uint64_t Residue<N>::reduce(unsigned __int128 value) {
+  uint64_t factor = static_cast<uint64_t>(value) * kInverse;
+  uint64_t result = (value + static_cast<unsigned __int128>(factor) * N) >> 64;
+  return result >= N ? result - N : result;
 }
 
-void BigInteger::changeSign() {
-  if (isZero()) {
-    return;
+template<size_t N>
+uint64_t Residue<N>::multiply(uint64_t first, uint64_t second) {
+  if constexpr (kMontgomery) {
+    return reduce(static_cast<unsigned __int128>(first) * second);
+  } else if constexpr (N <= (uint64_t(1) << 32)) {
+    return first * second % N;
+  } else {
+    return static_cast<unsigned __int128>(first) * second % N;
   }
-  sign = invertSign(sign);
-}
-
-BigInteger::BigInteger() : sign(Sign::NON_NEGATIVE) {
-  number.push_back(0);
 }
 
-BigInteger::BigInteger(int32_t num) : sign(Sign::NON_NEGATIVE) {
-  if (num == 0) {
-    number = {0};
-    return;
-  }
-  if (num < 0) {
-    num = -num;
-    sign = Sign::NEGATIVE;
+template<size_t N>
+uint64_t Residue<N>::toForm(uint64_t value) {
+  if constexpr (kMontgomery) {
+    return multiply(value, kSquare);
   }
+  return value;
+}
 
-  while (num > 0) {
-    number.push_back(num % kBase);
-    num /= kBase;
+template<size_t N>
+uint64_t Residue<N>::fromForm(uint64_t value) {
+  if constexpr (kMontgomery) {
+    return reduce(value);
   }
+  return value;
 }
 
-BigInteger::BigInteger(std::string str) : sign(Sign::NON_NEGATIVE) {
-  if (str[0] == '-') {
-    str.erase(str.begin());
-    sign = Sign::NEGATIVE;
-  }
+template<size_t N>
+Residue<N>::Residue(int num) {
+  int64_t res = num % static_cast<int64_t>(N);
+  num_ = toForm(res >= 0 ? res : N + res);
+}
 
-  int32_t rank = 1;
-  int32_t digit = 0;
-  for (size_t i = str.size(); i-- > 0;) {
-    if (rank == kBase) {
-      number.push_back(digit);
-      digit = 0;
-      rank = 1;
-    }
+template<size_t N>
+uint64_t Residue<N>::value() const {
+  return fromForm(num_);
+}
 
-    digit += rank * (str[i] - '0');
-    rank *= 10;
+template<size_t N>
+Residue<N>::operator int() const {
+  uint64_t result = fromForm(num_);
+  if (result > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+    throw std::out_of_range("Residue value does not fit in int");
   }
-  number.push_back(digit);
+  return static_cast<int>(result);
 }
 
-std::string BigInteger::toString() const {
-  std::string str;
-  if (sign == Sign::NEGATIVE) {
-    str = "-";
-  }
-  std::string digit;
-  for (size_t i = number.size(); i-- > 0;) {
-    digit = std::to_string(number[i]);
-    if (i + 1 != number.size()) {
-      digit.insert(0, std::string(kDigits - digit.size(), '0'));
+template<size_t N>
+Residue<N> Residue<N>::pow(Residue<N> number, uint64_t exp) {
+  Residue<N> result(1);
+  while (exp != 0) {
+    if (exp % 2 != 0) {
+      result *= number;
     }
-    str += digit;
+    number *= number;
+    exp /= 2;
   }
-  return str;
-}
-
-BigInteger::operator bool() const {
-  return !(number.empty() || (number.size() == 1 && number[0] == 0));
-}
-
-bool BigInteger::operator==(const BigInteger& other) const {
-  return sign == other.sign && number == other.number;
+  return result;
 }
 
-std::strong_ordering BigInteger::operator<=>(const BigInteger& other) const {
-  if (sign != other.sign) {
-    return sign < other.sign ? std::strong_ordering::less
-                             : std::strong_ordering::greater;
+template<size_t N>
+Residue<N> Residue<N>::inverse() const {
+  static_assert(isPrime(N));
+  int64_t first = fromForm(num_);
+  int64_t second = N;
+  int64_t first_factor = 1;
+  int64_t second_factor = 0;
+  while (second != 0) {
+    int64_t quotient = first / second;
+    first -= quotient * second;
+    first_factor -= quotient * second_factor;
+    std::swap(first, second);
+    std::swap(first_factor, second_factor);
   }
+  Residue<N> result;
+  result.num_ = toForm(first_factor >= 0 ? first_factor : first_factor + N);
+  return result;
+}
 
-  if (number.size() != other.number.size()) {
-    return (number.size() < other.number.size()) == (sign == Sign::NON_NEGATIVE)
-           ? std::strong_ordering::less : std::strong_ordering::greater;
+template<size_t N>
+void Residue<N>::batchInvert(std::vector<Residue<N>>& values) {
+  static_assert(isPrime(N));
+  std::vector<Residue<N>> prefix(values.size());
+  Residue<N> product(1);
+  for (size_t i = 0; i < values.size(); ++i) {
+    prefix[i] = product;
+    if (values[i] != 0) {
+      product *= values[i];
+    }
   }
-
-  for (size_t i = number.size(); i-- > 0;) {
-    if (number[i] != other.number[i]) {
-      return (number[i] < other.number[i]) == (sign == Sign::NON_NEGATIVE)
-             ? std::strong_ordering::less : std::strong_ordering::greater;
+  Residue<N> inverse = product.inverse();
+  for (size_t i = values.size(); i-- > 0;) {
+    if (values[i] == 0) {
+      continue;
     }
+    Residue<N> value = values[i];
+    values[i] = inverse * prefix[i];
+    inverse *= value;
   }
-  return std::strong_ordering::equal;
 }
 
-BigInteger& BigInteger::operator++() {
-  if (isZero()) {
-    *this = 1;
-    return *this;
-  }
+template<size_t N>
+bool Residue<N>::operator==(const Residue<N>& other) const {
+  return num_ == other.num_;
+}
 
-  if (sign == Sign::NON_NEGATIVE) {
-    for (int64_t& digit : number) {
-      ++digit;
-      if (digit == kBase) {
-        digit = 0;
-        continue;
-      }
-      return *this;
-    }
-    number.push_back(1);
-    return *this;
+template<size_t N>
+Residue<N>& Residue<N>::operator+=(const Residue<N>& other) {
+  num_ += other.num_;
+  if (num_ >= N) {
+    num_ -= N;
   }
+  return *this;
+}
 
-  if (isMinusOne()) {
-    *this = 0;
-    return *this;
-  }
+template<size_t N>
+Residue<N>& Residue<N>::operator-=(const Residue<N>& other) {
+  num_ = num_ >= other.num_ ? num_ - other.num_ : num_ + N - other.num_;
+  return *this;
+}
 
-  for (size_t i = 0; i < number.size(); ++i) {
-    if (number[i] == 0) {
-      number[i] = kBase - 1;
-      continue;
-    }
-    --number[i];
-    if (number[i] == 0 && i + 1 == number.size()) {
-      number.pop_back();
-    }
-    return *this;
-  }
+template<size_t N>
+Residue<N>& Residue<N>::operator*=(const Residue<N>& other) {
+  num_ = multiply(num_, other.num_);
   return *this;
 }
 
-BigInteger& BigInteger::operator--() {
-  if (isZero()) {
-    *this = -1;
-    return *this;
-  }
-  sign = invertSign(sign);
-  ++*this;
-  if (isZero()) {
-    return *this;
-  }
-  sign = invertSign(sign);
+template<size_t N>
+Residue<N>& Residue<N>::operator/=(const Residue<N>& other) {
+  static_assert(isPrime(N));
+  num_ = multiply(num_, other.inverse().num_);
   return *this;
 }
 
-BigInteger BigInteger::operator++(int32_t) {
-  BigInteger result = *this;
-  ++*this;
-  return result;
+template<size_t N>
+Residue<N> operator+(const Residue<N>& num1, const Residue<N>& num2) {
+  Residue<N> tmp(num1);
+  tmp += num2;
+  return tmp;
 }
 
-BigInteger BigInteger::operator--(int32_t) {
-  BigInteger result = *this;
-  --*this;
-  return result;
+template<size_t N>
+Residue<N> operator-(const Residue<N>& num1, const Residue<N>& num2) {
+  Residue<N> tmp(num1);
+  tmp -= num2;
+  return tmp;
 }
 
-void BigInteger::add(const BigInteger& other) {
-  int64_t rest = 0;
-  size_t old_size = number.size();
-  size_t max_size = std::max(number.size(), other.number.size());
-  number.resize(max_size + 1);
-  for (size_t i = 0; i < max_size + 1; ++i) {
-    if (i < old_size) {
-      rest += number[i];
-    }
+template<size_t N>
+Residue<N> operator*(const Residue<N>& num1, const Residue<N>& num2) {
+  Residue<N> tmp(num1);
+  tmp *= num2;
+  return tmp;
+}
 
-    if (i < other.number.size()) {
-      rest += other.number[i];
-    }
+template<size_t N>
+Residue<N> operator/(const Residue<N>& num1, const Residue<N>& num2) {
+  Residue<N> tmp(num1);
+  tmp /= num2;
+  return tmp;
+}
 
-    number[i] = rest % kBase;
-    rest /= kBase;
-  }
-  for (size_t i = number.size(); i-- > 0;) {
-    if (number[i] != 0) {
-      number.resize(i + 1);
-      return;
-    }
-  }
-  *this = 0;
+template<size_t N>
+std::ostream& operator<<(std::ostream& os, const Residue<N>& num) {
+  os << num.value();
+  return os;
+}
+std::ostream& operator<<(std::ostream& os, const Rational& num) {
+  os << static_cast<double>(num);
+  return os;
 }
 
-void BigInteger::subtract(const BigInteger& other) {
-  Sign res_sign = sign;
+class ThreadPool {
+  struct Worker {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
 
-  Sign diff_sign;
-  sign = other.sign;
-  if ((*this < other) == (sign == Sign::NON_NEGATIVE)) {
-    diff_sign = Sign::NEGATIVE;
-    res_sign =
-        (res_sign == Sign::NEGATIVE ? Sign::NON_NEGATIVE : Sign::NEGATIVE);
-  } else {
-    diff_sign = Sign::NON_NEGATIVE;
-  }
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::atomic<size_t> pending_ = 0;
+  bool stop_ = false;
 
-  sign = res_sign;
-  int64_t rest = 0;
-  size_t old_size = number.size();
-  size_t max_size = std::max(number.size(), other.number.size());
-  number.resize(max_size + 1);
-  for (size_t i = 0; i < max_size + 1; ++i) {
-    if (i < old_size) {
-      rest += number[i] * (diff_sign == Sign::NON_NEGATIVE ? 1 : -1);
-    }
+  bool popTask(size_t index, std::function<void()>& task);
 
-    if (i < other.number.size()) {
-      rest -= other.number[i] * (diff_sign == Sign::NON_NEGATIVE ? 1 : -1);
-    }
+  void run(size_t index);
 
-    if (rest < 0) {
-      number[i] = kBase + rest;
-      rest = -1;
-    } else {
-      number[i] = rest % kBase;
-      rest /= kBase;
-    }
-  }
+ public:
+  explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
 
-  for (size_t i = number.size(); i-- > 0;) {
-    if (number[i] != 0) {
-      number.resize(i + 1);
-      return;
-    }
-  }
-  *this = 0;
-}
+  ThreadPool(const ThreadPool&) = delete;
 
-BigInteger& BigInteger::operator+=(const BigInteger& other) {
-  if (isZero()) {
-    *this = other;
-    return *this;
-  }
-  if (other == 0) {
-    return *this;
-  }
+  ThreadPool& operator=(const ThreadPool&) = delete;
 
-  if (sign == other.sign) {
-    add(other);
-  } else {
-    subtract(other);
-  }
-  return *this;
-}
+  ~ThreadPool();
 
-BigInteger& BigInteger::operator-=(const BigInteger& other) {
-  sign = invertSign(sign);
-  *this += other;
-  if (isZero()) {
-    return *this;
-  }
-  sign = invertSign(sign);
-  return *this;
-}
+  size_t size() const;
 
-BigInteger BigInteger::multiply(BigInteger num, int64_t factor) {
-  if (factor == 0) {
-    return 0;
-  }
+  template<typename Body>
+  void parallelFor(size_t begin, size_t end, const Body& body);
+};
 
-  int64_t rest = 0;
-  for (int64_t& bit : num.number) {
-    rest += bit * factor;
-    bit = rest % kBase;
-    rest /= kBase;
+ThreadPool::ThreadPool(size_t threads) {
+  size_t count = std::max<size_t>(threads, 1);
+  for (size_t i = 0; i < count; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
   }
+  for (size_t i = 1; i < count; ++i) {
+    threads_.emplace_back(&ThreadPool::run, this, i);
+  }
+}
 
-  if (rest != 0) {
-    num.number.push_back(rest);
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
   }
-  return num;
 }
 
-BigInteger BigInteger::shiftBit(size_t count) const {
-  BigInteger result = *this;
-  std::vector<int64_t> zeros(count);
-  result.number.insert(result.number.begin(), zeros.begin(), zeros.end());
-  return result;
+size_t ThreadPool::size() const {
+  return workers_.size();
 }
 
-BigInteger& BigInteger::operator*=(const BigInteger& other) {
-  if (isZero() || other == 0) {
-    *this = 0;
-    return *this;
+bool ThreadPool::popTask(size_t index, std::function<void()>& task) {
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    Worker& worker = *workers_[(index + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+      continue;
+    }
+    if (i == 0) {
+      task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+    } else {
+      task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+    }
+    --pending_;
+    return true;
   }
+  return false;
+}
 
-  sign = (sign == other.sign ? Sign::NON_NEGATIVE : Sign::NEGATIVE);
-  BigInteger result = 0;
-  for (size_t i = 0; i < other.number.size(); ++i) {
-    result += multiply(*this, other.number[i]).shiftBit(i);
+void ThreadPool::run(size_t index) {
+  std::function<void()> task;
+  while (true) {
+    if (popTask(index, task)) {
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_.wait(lock, [this] { return stop_ || pending_ != 0; });
+    if (stop_ && pending_ == 0) {
+      return;
+    }
   }
-  *this = result;
-  return *this;
 }
 
-BigInteger& BigInteger::operator/=(const BigInteger& divisor) {
-  Sign res_sign = (sign == divisor.sign ? Sign::NON_NEGATIVE : Sign::NEGATIVE);
-  sign = Sign::NON_NEGATIVE;
-  BigInteger div = divisor;
-  div.sign = Sign::NON_NEGATIVE;
-
-  if (*this < div) {
-    *this = 0;
-    return *this;
+template<typename Body>
+void ThreadPool::parallelFor(size_t begin, size_t end, const Body& body) {
+  if (end <= begin) {
+    return;
   }
-  if (*this == div) {
-    *this = 1;
-    sign = res_sign;
-    return *this;
+  size_t chunks = std::min(end - begin, 4 * workers_.size());
+  if (chunks < 2) {
+    body(begin, end);
+    return;
   }
-
-  size_t len;
-  size_t mod_len = div.length();
-  size_t zero_count;
-  BigInteger shift_mod;
-  BigInteger tmp_mod;
-  BigInteger factor;
-  BigInteger result;
-  while (div <= *this) {
-    len = length();
-    shift_mod = div.shift(len - mod_len);
-    zero_count = len - mod_len;
-    if (*this < shift_mod) {
-      shift_mod = div.shift(len - mod_len - 1);
-      zero_count = len - mod_len - 1;
-    }
-
-    factor = 1;
-    tmp_mod = shift_mod;
-    while (tmp_mod < *this) {
-      tmp_mod += shift_mod;
-      ++factor;
+  std::atomic<size_t> remaining = 0;
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto drain = [this, &remaining] {
+    std::function<void()> task;
+    while (remaining.load(std::memory_order_acquire) != 0) {
+      if (popTask(0, task)) {
+        task();
+      } else {
+        std::this_thread::yield();
+      }
     }
-
-    if (tmp_mod == *this) {
-      result += factor.shift(zero_count);
-      *this = result;
-      sign = res_sign;
-      return *this;
+  };
+  size_t step = (end - begin) / chunks;
+  size_t extra = (end - begin) % chunks;
+  try {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t first = begin;
+    for (size_t i = 0; i < chunks; ++i) {
+      size_t last = first + step + (i < extra ? 1 : 0);
+      Worker& worker = *workers_[i % workers_.size()];
+      std::lock_guard<std::mutex> worker_lock(worker.mutex);
+      worker.tasks.emplace_back(
+          [&body, &remaining, &error, &error_mutex, first, last] {
+            try {
+              body(first, last);
+            } catch (...) {
+              std::lock_guard<std::mutex> error_lock(error_mutex);
+              if (!error) {
+                error = std::current_exception();
+              }
+            }
+            remaining.fetch_sub(1, std::memory_order_release);
+          });
+      remaining.fetch_add(1, std::memory_order_relaxed);
+      ++pending_;
+      first = last;
     }
-
-    tmp_mod -= shift_mod;
-    --factor;
-    result += factor.shift(zero_count);
-    *this -= tmp_mod;
+  } catch (...) {
+    wake_.notify_all();
+    drain();
+    throw;
+  }
+  wake_.notify_all();
+  drain();
+  if (error) {
+    std::rethrow_exception(error);
   }
-  *this = result;
-  sign = res_sign;
-  return *this;
 }
 
-BigInteger& BigInteger::operator%=(const BigInteger& divisor) {
-  BigInteger dividend = *this;
-  dividend /= divisor;
-  dividend *= divisor;
-  *this -= dividend;
-  return *this;
-}
+template<typename Field>
+class DynMatrix;
 
-size_t BigInteger::length() const {
-  return (number.size() - 1) * kDigits +
-      std::to_string(number.back()).size();
-}
+template<typename Field>
+class LUDecomposition;
 
-BigInteger BigInteger::shift(size_t count) const {
-  BigInteger result = *this;
-  result *= BigInteger("1" + std::string(count % kDigits, '0'));
-  std::vector<int64_t> zeros(count / kDigits);
-  result.number.insert(result.number.begin(), zeros.begin(), zeros.end());
-  return result;
-}
+template<typename Field>
+class SparseMatrix;
 
-bool BigInteger::isZero() const {
-  return number.size() == 1 && number[0] == 0;
+std::string shapeName(size_t rows, size_t columns) {
+  return std::to_string(rows) + "x" + std::to_string(columns);
 }
 
-bool BigInteger::isMinusOne() const {
-  return number.size() == 1 && number[0] == 1 && sign == Sign::NEGATIVE;
-}
+template<typename Type>
+struct MatrixTraits {
+  static constexpr bool kIsMatrix = false;
+  static constexpr bool kIsExpression = false;
+};
 
-BigInteger operator+(const BigInteger& num1, const BigInteger& num2) {
-  BigInteger result(num1);
-  result += num2;
-  return result;
-}
+template<typename Left, typename Right>
+concept MatrixOperands =
+    MatrixTraits<Left>::kIsMatrix && MatrixTraits<Right>::kIsMatrix &&
+    MatrixTraits<Left>::kRows == MatrixTraits<Right>::kRows &&
+    MatrixTraits<Left>::kColumns == MatrixTraits<Right>::kColumns &&
+    std::is_same_v<typename MatrixTraits<Left>::Value,
+                   typename MatrixTraits<Right>::Value>;
 
-BigInteger operator-(const BigInteger& num1, const BigInteger& num2) {
-  BigInteger result(num1);
-  result -= num2;
-  return result;
-}
+template<typename Left, typename Right>
+concept MatrixProductOperands =
+    MatrixTraits<Left>::kIsMatrix && MatrixTraits<Right>::kIsMatrix &&
+    MatrixTraits<Left>::kColumns == MatrixTraits<Right>::kRows &&
+    std::is_same_v<typename MatrixTraits<Left>::Value,
+                   typename MatrixTraits<Right>::Value>;
 
-BigInteger operator*(const BigInteger& num1, const BigInteger& num2) {
-  BigInteger result(num1);
-  result *= num2;
-  return result;
-}
+template<typename Left, typename Right>
+concept MatrixExpressionOperands =
+    MatrixTraits<Left>::kIsExpression || MatrixTraits<Right>::kIsExpression;
 
-BigInteger operator/(const BigInteger& num1, const BigInteger& num2) {
-  BigInteger result(num1);
-  result /= num2;
-  return result;
-}
+template<typename Field>
+class MatrixKernels {
+#if defined(__AVX512F__)
+  static constexpr size_t kTileColumns = 128 / sizeof(Field);
 
-BigInteger operator%(const BigInteger& num1, const BigInteger& num2) {
-  BigInteger result(num1);
-  result %= num2;
-  return result;
-}
+  static __m512d loadLanes(const double* ptr) { return _mm512_loadu_pd(ptr); }
+
+  static __m512 loadLanes(const float* ptr) { return _mm512_loadu_ps(ptr); }
 
-BigInteger operator-(const BigInteger& num) {
-  BigInteger result = num;
-  if (result != 0) {
-    result.changeSign();
+  static __m512d broadcastLane(const double* ptr) {
+    return _mm512_set1_pd(*ptr);
   }
-  return result;
-}
 
-BigInteger operator "" _bi(unsigned long long num) {
-  BigInteger result(std::to_string(num));
-  return result;
-}
+  static __m512 broadcastLane(const float* ptr) { return _mm512_set1_ps(*ptr); }
 
-std::ostream& operator<<(std::ostream& os, const BigInteger& num) {
-  return os << num.toString();
-}
+  static __m512d fmaLanes(__m512d first, __m512d second, __m512d sum) {
+    return _mm512_fmadd_pd(first, second, sum);
+  }
 
-std::istream& operator>>(std::istream& is, BigInteger& num) {
-  std::string str;
-  is >> str;
-  num = BigInteger(str);
-  return is;
-}
+  static __m512 fmaLanes(__m512 first, __m512 second, __m512 sum) {
+    return _mm512_fmadd_ps(first, second, sum);
+  }
 
-class Rational {
-  BigInteger numerator;
+  static void storeLanes(double* ptr, __m512d value) {
+    _mm512_storeu_pd(ptr, value);
+  }
 
-  BigInteger denominator;
+  static void storeLanes(float* ptr, __m512 value) {
+    _mm512_storeu_ps(ptr, value);
+  }
+#elif defined(__AVX2__) && defined(__FMA__)
+  static constexpr size_t kTileColumns = 64 / sizeof(Field);
 
-  static BigInteger gcd(BigInteger first, BigInteger second);
+  static __m256d loadLanes(const double* ptr) { return _mm256_loadu_pd(ptr); }
 
-  void reduce();
+  static __m256 loadLanes(const float* ptr) { return _mm256_loadu_ps(ptr); }
 
- public:
-  Rational();
+  static __m256d broadcastLane(const double* ptr) {
+    return _mm256_broadcast_sd(ptr);
+  }
 
-  Rational(BigInteger num, BigInteger denom);
+  static __m256 broadcastLane(const float* ptr) {
+    return _mm256_broadcast_ss(ptr);
+  }
 
-  Rational(BigInteger num);
+  static __m256d fmaLanes(__m256d first, __m256d second, __m256d sum) {
+    return _mm256_fmadd_pd(first, second, sum);
+  }
 
-  Rational(int32_t num, int32_t denom);
+  static __m256 fmaLanes(__m256 first, __m256 second, __m256 sum) {
+    return _mm256_fmadd_ps(first, second, sum);
+  }
 
-  Rational(int32_t num);
+  static void storeLanes(double* ptr, __m256d value) {
+    _mm256_storeu_pd(ptr, value);
+  }
 
-  std::string toString() const;
+  static void storeLanes(float* ptr, __m256 value) {
+    _mm256_storeu_ps(ptr, value);
+  }
+#else
+  static constexpr size_t kTileColumns = 8;
+#endif
 
-  std::string asDecimal(int32_t precision) const;
+  static constexpr size_t kTileRows = 6;
+  static constexpr size_t kBlockRows = 16 * kTileRows;
+  static constexpr size_t kBlockDepth = 256;
+  static constexpr size_t kBlockColumns = 64 * kTileColumns;
+  static constexpr size_t kParallelWork =
+      std::is_arithmetic_v<Field> ? 1 << 15 : 1 << 8;
 
-  explicit operator double() const;
+  template<typename Body>
+  static void forRows(ThreadPool* pool, size_t begin, size_t end, size_t cost,
+                      const Body& body);
 
-  bool operator==(const Rational& other) const;
+  static void packRows(const Field* source, size_t stride, size_t rows,
+                       size_t depth, Field* packed);
 
-  std::strong_ordering operator<=>(const Rational& other) const;
+  static void packColumns(const Field* source, size_t stride, size_t depth,
+                          size_t columns, Field* packed);
 
-  Rational& operator+=(const Rational& other);
+  static void multiplyTile(const Field* packed_first,
+                           const Field* packed_second, size_t depth,
+                           Field* tile);
 
-  Rational& operator-=(const Rational& other);
+  static void multiplyBlocked(const Field* first, const Field* second,
+                              Field* result, size_t rows, size_t depth,
+                              size_t columns);
 
-  Rational& operator*=(const Rational& other);
+  static void combineBlocks(const Field* first, size_t first_stride,
+                            const Field* second, size_t second_stride,
+                            Field* result, size_t result_stride, size_t size,
+                            bool subtract);
 
-  Rational& operator/=(const Rational& other);
+  static void multiplyStrassen(const Field* first, size_t first_stride,
+                               const Field* second, size_t second_stride,
+                               Field* result, size_t result_stride,
+                               size_t size, size_t threshold);
 
-  Rational operator-() const;
-};
+  static std::vector<std::vector<BigInteger>> integerRows(
+      const std::vector<Field>& matrix, size_t rows, size_t columns,
+      std::vector<BigInteger>& scales);
 
-void Rational::reduce() {
-  if (denominator < 0) {
-    numerator.changeSign();
-    denominator.changeSign();
-  }
-  BigInteger gcd_num = gcd(numerator, denominator);
-  numerator /= gcd_num;
-  denominator /= gcd_num;
-}
+  static size_t eliminateBareiss(std::vector<std::vector<BigInteger>>& matrix,
+                                 size_t columns, bool jordan, bool& negative,
+                                 ThreadPool* pool);
 
-Rational::Rational(BigInteger num, BigInteger denom)
-    : numerator(num), denominator(denom) {
-  reduce();
-}
+ public:
+  static void multiply(const Field* first, const Field* second, Field* result,
+                       size_t rows, size_t depth, size_t columns,
+                       size_t strassen_threshold, ThreadPool* pool);
 
-Rational::Rational() : Rational(0, 1) {}
+  static Field det(std::vector<Field> matrix, size_t size, ThreadPool* pool);
 
-Rational::Rational(BigInteger num) : numerator(num), denominator(1) {
-  reduce();
-}
+  static std::vector<Field> transposed(const std::vector<Field>& matrix,
+                                       size_t rows, size_t columns);
 
-Rational::Rational(int32_t num, int32_t denom)
-    : numerator(num), denominator(denom) {
-  reduce();
-}
+  static size_t rank(std::vector<Field> matrix, size_t rows, size_t columns,
+                     ThreadPool* pool);
 
-Rational::Rational(int32_t num) : numerator(num), denominator(1) {
-  reduce();
-}
+  static void invert(std::vector<Field>& matrix, size_t size,
+                     ThreadPool* pool);
+
+  static size_t factorize(std::vector<Field>& matrix, size_t size,
+                          std::vector<size_t>& permutation,
+                          std::vector<Field>& inverses, bool& negative,
+                          ThreadPool* pool);
+};
 
-std::string Rational::toString() const {
-  std::string result = numerator.toString();
-  if (denominator != 1) {
-    result += "/" + denominator.toString();
+template<typename Field>
+template<typename Body>
+void MatrixKernels<Field>::forRows(ThreadPool* pool, size_t begin, size_t end,
+                                   size_t cost, const Body& body) {
+  if (pool == nullptr || pool->size() < 2 || end <= begin ||
+      (end - begin) * cost < kParallelWork) {
+    body(begin, end);
+    return;
   }
-  return result;
+  pool->parallelFor(begin, end, body);
 }
 
-std::string Rational::asDecimal(int32_t precision = 0) const {
-  BigInteger
-      shift_num = numerator * BigInteger("1" + std::string(precision, '0'));
-  if (shift_num < 0) {
-    shift_num.changeSign();
+template<typename Field>
+void MatrixKernels<Field>::packRows(const Field* source, size_t stride,
+                                    size_t rows, size_t depth, Field* packed) {
+  for (size_t i = 0; i < rows; i += kTileRows) {
+    size_t tile_rows = std::min(kTileRows, rows - i);
+    for (size_t k = 0; k < depth; ++k) {
+      for (size_t j = 0; j < kTileRows; ++j) {
+        *packed++ = j < tile_rows ? source[(i + j) * stride + k] : Field(0);
+      }
+    }
   }
+}
 
-  BigInteger fraction = shift_num / denominator;
-  std::string result = fraction.toString();
-  if (static_cast<int32_t>(result.size()) <= precision) {
-    result =
-        std::string(static_cast<size_t>(precision) + 1 - result.size(), '0') +
-            result;
+template<typename Field>
+void MatrixKernels<Field>::packColumns(const Field* source, size_t stride,
+                                       size_t depth, size_t columns,
+                                       Field* packed) {
+  for (size_t j = 0; j < columns; j += kTileColumns) {
+    size_t tile_columns = std::min(kTileColumns, columns - j);
+    for (size_t k = 0; k < depth; ++k) {
+      const Field* row = source + k * stride + j;
+      std::copy(row, row + tile_columns, packed);
+      std::fill(packed + tile_columns, packed + kTileColumns, Field(0));
+      packed += kTileColumns;
+    }
   }
+}
 
-  if (precision != 0) {
-    result.insert(result.end() - precision, '.');
+template<typename Field>
+void MatrixKernels<Field>::multiplyTile(const Field* packed_first,
+                                        const Field* packed_second,
+                                        size_t depth, Field* tile) {
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+  constexpr size_t kLanes = kTileColumns / 2;
+  using Lanes = decltype(loadLanes(packed_second));
+  Lanes sum[kTileRows][2] = {};
+  for (size_t k = 0; k < depth; ++k) {
+    Lanes low = loadLanes(packed_second);
+    Lanes high = loadLanes(packed_second + kLanes);
+#pragma GCC unroll 6
+    for (size_t i = 0; i < kTileRows; ++i) {
+      Lanes value = broadcastLane(packed_first + i);
+      sum[i][0] = fmaLanes(value, low, sum[i][0]);
+      sum[i][1] = fmaLanes(value, high, sum[i][1]);
+    }
+    packed_first += kTileRows;
+    packed_second += kTileColumns;
   }
-  if (numerator < 0 && fraction != 0) {
-    result.insert(0, 1, '-');
+#pragma GCC unroll 6
+  for (size_t i = 0; i < kTileRows; ++i) {
+    storeLanes(tile + i * kTileColumns, sum[i][0]);
+    storeLanes(tile + i * kTileColumns + kLanes, sum[i][1]);
+  }
+#else
+  std::fill(tile, tile + kTileRows * kTileColumns, Field(0));
+  for (size_t k = 0; k < depth; ++k) {
+    for (size_t i = 0; i < kTileRows; ++i) {
+      for (size_t j = 0; j < kTileColumns; ++j) {
+        tile[i * kTileColumns + j] += packed_first[i] * packed_second[j];
+      }
+    }
+    packed_first += kTileRows;
+    packed_second += kTileColumns;
+  }
+#endif
+}
+
+template<typename Field>
+void MatrixKernels<Field>::multiplyBlocked(const Field* first,
+                                           const Field* second, Field* result,
+                                           size_t rows, size_t depth,
+                                           size_t columns) {
+  std::vector<Field> packed_first(kBlockRows * kBlockDepth);
+  std::vector<Field> packed_second(kBlockDepth * kBlockColumns);
+  std::array<Field, kTileRows * kTileColumns> tile;
+  for (size_t jc = 0; jc < columns; jc += kBlockColumns) {
+    size_t block_columns = std::min(kBlockColumns, columns - jc);
+    for (size_t pc = 0; pc < depth; pc += kBlockDepth) {
+      size_t block_depth = std::min(kBlockDepth, depth - pc);
+      packColumns(second + pc * columns + jc, columns, block_depth,
+                  block_columns, packed_second.data());
+      for (size_t ic = 0; ic < rows; ic += kBlockRows) {
+        size_t block_rows = std::min(kBlockRows, rows - ic);
+        packRows(first + ic * depth + pc, depth, block_rows, block_depth,
+                 packed_first.data());
+        for (size_t jr = 0; jr < block_columns; jr += kTileColumns) {
+          size_t tile_columns = std::min(kTileColumns, block_columns - jr);
+          for (size_t ir = 0; ir < block_rows; ir += kTileRows) {
+            size_t tile_rows = std::min(kTileRows, block_rows - ir);
+            multiplyTile(packed_first.data() + ir * block_depth,
+                         packed_second.data() + jr * block_depth, block_depth,
+                         tile.data());
+            Field* target = result + (ic + ir) * columns + jc + jr;
+            for (size_t i = 0; i < tile_rows; ++i) {
+              for (size_t j = 0; j < tile_columns; ++j) {
+                target[i * columns + j] += tile[i * kTileColumns + j];
+              }
+            }
+          }
+        }
+      }
+    }
   }
-  return result;
-}
-
-Rational::operator double() const {
-  return std::stod(asDecimal(15));
 }
 
-bool Rational::operator==(const Rational& other) const {
-  return numerator == other.numerator && denominator == other.denominator;
+template<typename Field>
+void MatrixKernels<Field>::combineBlocks(const Field* first,
+                                         size_t first_stride,
+                                         const Field* second,
+                                         size_t second_stride, Field* result,
+                                         size_t result_stride, size_t size,
+                                         bool subtract) {
+  for (size_t i = 0; i < size; ++i) {
+    for (size_t j = 0; j < size; ++j) {
+      Field value = first[i * first_stride + j];
+      if (subtract) {
+        value -= second[i * second_stride + j];
+      } else {
+        value += second[i * second_stride + j];
+      }
+      result[i * result_stride + j] = std::move(value);
+    }
+  }
 }
 
-std::strong_ordering Rational::operator<=>(const Rational& other) const {
-  return numerator * other.denominator <=> other.numerator * denominator;
-}
-
-Rational& Rational::operator+=(const Rational& other) {
-  BigInteger gcd_num = gcd(denominator, other.denominator);
-  BigInteger left_factor = other.denominator / gcd_num;
-  BigInteger right_factor = denominator / gcd_num;
-  numerator = numerator * left_factor + other.numerator * right_factor;
-  denominator = denominator * left_factor;
-  reduce();
-  return *this;
-}
-
-Rational& Rational::operator-=(const Rational& other) {
-  numerator.changeSign();
-  *this += other;
-  numerator.changeSign();
-  reduce();
-  return *this;
-}
-
-Rational& Rational::operator*=(const Rational& other) {
-  numerator *= other.numerator;
-  denominator *= other.denominator;
-  reduce();
-  return *this;
-}
-
-Rational& Rational::operator/=(const Rational& other) {
-  numerator *= other.denominator;
-  denominator *= other.numerator;
-  reduce();
-  return *this;
-}
-
-Rational Rational::operator-() const {
-  Rational result(*this);
-  result.numerator.changeSign();
-  return result;
-}
-
-Rational operator+(const Rational& num1, const Rational& num2) {
-  Rational result(num1);
-  result += num2;
-  return result;
-}
+template<typename Field>
+void MatrixKernels<Field>::multiplyStrassen(const Field* first,
+                                            size_t first_stride,
+                                            const Field* second,
+                                            size_t second_stride,
+                                            Field* result,
+                                            size_t result_stride, size_t size,
+                                            size_t threshold) {
+  if (size <= threshold || size < 2) {
+    for (size_t i = 0; i < size; ++i) {
+      Field* row = result + i * result_stride;
+      std::fill(row, row + size, Field(0));
+      for (size_t j = 0; j < size; ++j) {
+        const Field& factor = first[i * first_stride + j];
+        for (size_t k = 0; k < size; ++k) {
+          row[k] += factor * second[j * second_stride + k];
+        }
+      }
+    }
+    return;
+  }
 
-Rational operator-(const Rational& num1, const Rational& num2) {
-  Rational result(num1);
-  result -= num2;
-  return result;
-}
+  size_t half = size / 2;
+  if (size % 2 != 0) {
+    size_t last = size - 1;
+    multiplyStrassen(first, first_stride, second, second_stride, result,
+                     result_stride, last, threshold);
+    for (size_t i = 0; i < last; ++i) {
+      const Field& factor = first[i * first_stride + last];
+      for (size_t k = 0; k < last; ++k) {
+        result[i * result_stride + k] +=
+            factor * second[last * second_stride + k];
+      }
+    }
+    for (size_t i = 0; i < size; ++i) {
+      Field sum = 0;
+      for (size_t j = 0; j < size; ++j) {
+        sum += first[i * first_stride + j] * second[j * second_stride + last];
+      }
+      result[i * result_stride + last] = sum;
+    }
+    for (size_t k = 0; k < last; ++k) {
+      Field sum = 0;
+      for (size_t j = 0; j < size; ++j) {
+        sum += first[last * first_stride + j] * second[j * second_stride + k];
+      }
+      result[last * result_stride + k] = sum;
+    }
+    return;
+  }
 
-Rational operator*(const Rational& num1, const Rational& num2) {
-  Rational result(num1);
-  result *= num2;
+  const Field* a11 = first;
+  const Field* a12 = first + half;
+  const Field* a21 = first + half * first_stride;
+  const Field* a22 = a21 + half;
+  const Field* b11 = second;
+  const Field* b12 = second + half;
+  const Field* b21 = second + half * second_stride;
+  const Field* b22 = b21 + half;
+  Field* c11 = result;
+  Field* c12 = result + half;
+  Field* c21 = result + half * result_stride;
+  Field* c22 = c21 + half;
+
+  size_t block = half * half;
+  std::vector<Field> buffer(4 * block);
+  Field* s = buffer.data();
+  Field* t = s + block;
+  Field* p = t + block;
+  Field* u = p + block;
+
+  combineBlocks(a21, first_stride, a22, first_stride, s, half, half, false);
+  combineBlocks(b12, second_stride, b11, second_stride, t, half, half, true);
+  multiplyStrassen(s, half, t, half, c22, result_stride, half, threshold);
+  multiplyStrassen(a11, first_stride, b11, second_stride, p, half, half,
+                   threshold);
+  combineBlocks(s, half, a11, first_stride, s, half, half, true);
+  combineBlocks(b22, second_stride, t, half, t, half, half, true);
+  multiplyStrassen(s, half, t, half, u, half, half, threshold);
+  combineBlocks(u, half, p, half, u, half, half, false);
+  combineBlocks(a12, first_stride, s, half, s, half, half, true);
+  multiplyStrassen(s, half, b22, second_stride, c12, result_stride, half,
+                   threshold);
+  combineBlocks(c12, result_stride, c22, result_stride, c12, result_stride,
+                half, false);
+  combineBlocks(c12, result_stride, u, half, c12, result_stride, half, false);
+  combineBlocks(t, half, b21, second_stride, t, half, half, true);
+  multiplyStrassen(a22, first_stride, t, half, c21, result_stride, half,
+                   threshold);
+  combineBlocks(a11, first_stride, a21, first_stride, s, half, half, true);
+  combineBlocks(b22, second_stride, b12, second_stride, t, half, half, true);
+  multiplyStrassen(s, half, t, half, c11, result_stride, half, threshold);
+  combineBlocks(u, half, c11, result_stride, u, half, half, false);
+  combineBlocks(u, half, c21, result_stride, c21, result_stride, half, true);
+  combineBlocks(u, half, c22, result_stride, c22, result_stride, half, false);
+  multiplyStrassen(a12, first_stride, b21, second_stride, c11, result_stride,
+                   half, threshold);
+  combineBlocks(c11, result_stride, p, half, c11, result_stride, half, false);
+}
+
+template<typename Field>
+std::vector<std::vector<BigInteger>> MatrixKernels<Field>::integerRows(
+    const std::vector<Field>& matrix, size_t rows, size_t columns,
+    std::vector<BigInteger>& scales) {
+  std::vector<std::vector<BigInteger>> result(rows);
+  scales.assign(rows, 1);
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < columns; ++j) {
+      const BigInteger& denominator = matrix[i * columns + j].getDenominator();
+      if (denominator != 1) {
+        scales[i] /= BigInteger::gcd(scales[i], denominator);
+        scales[i] *= denominator;
+      }
+    }
+    result[i].reserve(columns);
+    for (size_t j = 0; j < columns; ++j) {
+      const Field& value = matrix[i * columns + j];
+      result[i].push_back(value.getNumerator());
+      if (value.getDenominator() != scales[i]) {
+        result[i].back() *= scales[i] / value.getDenominator();
+      }
+    }
+  }
   return result;
 }
 
-Rational operator/(const Rational& num1, const Rational& num2) {
-  Rational result(num1);
-  result /= num2;
-  return result;
-}
+template<typename Field>
+size_t MatrixKernels<Field>::eliminateBareiss(
+    std::vector<std::vector<BigInteger>>& matrix, size_t columns, bool jordan,
+    bool& negative, ThreadPool* pool) {
+  BigInteger previous = 1;
+  size_t rank = 0;
+  negative = false;
+  for (size_t i = 0; i < columns && rank < matrix.size(); ++i) {
+    size_t non_zero = rank;
+    while (non_zero < matrix.size() && matrix[non_zero][i] == 0) {
+      ++non_zero;
+    }
 
-std::istream& operator>>(std::istream& is, Rational& num) {
-  int32_t int_num;
-  is >> int_num;
-  num = int_num;
-  return is;
-}
+    if (non_zero == matrix.size()) {
+      continue;
+    }
+    if (non_zero != rank) {
+      std::swap(matrix[rank], matrix[non_zero]);
+      negative = !negative;
+    }
 
-BigInteger Rational::gcd(BigInteger first, BigInteger second) {
-  if (first < 0) {
-    first.changeSign();
+    const std::vector<BigInteger>& pivot = matrix[rank];
+    size_t first_row = jordan ? 0 : rank + 1;
+    size_t first_column = jordan ? 0 : i + 1;
+    forRows(pool, first_row, matrix.size(), pivot.size() - first_column,
+            [&](size_t begin, size_t end) {
+      BigInteger product;
+      for (size_t j = begin; j < end; ++j) {
+        if (j == rank) {
+          continue;
+        }
+        for (size_t k = first_column; k < matrix[j].size(); ++k) {
+          if (k == i) {
+            continue;
+          }
+          matrix[j][k] *= pivot[i];
+          if (matrix[j][i] != 0 && pivot[k] != 0) {
+            product = matrix[j][i];
+            product *= pivot[k];
+            matrix[j][k] -= product;
+          }
+          if (previous != 1) {
+            matrix[j][k] /= previous;
+          }
+        }
+        matrix[j][i] = 0;
+      }
+    });
+    previous = pivot[i];
+    ++rank;
   }
-  if (second < 0) {
-    second.changeSign();
+  return rank;
+}
+
+template<typename Field>
+void MatrixKernels<Field>::multiply(const Field* first, const Field* second,
+                                    Field* result, size_t rows, size_t depth,
+                                    size_t columns, size_t strassen_threshold,
+                                    ThreadPool* pool) {
+  if constexpr (std::is_same_v<Field, double> ||
+                std::is_same_v<Field, float>) {
+    size_t blocks = (rows + kBlockRows - 1) / kBlockRows;
+    forRows(pool, 0, blocks, kBlockRows * depth * columns,
+            [&](size_t begin, size_t end) {
+      size_t first_row = begin * kBlockRows;
+      size_t last_row = std::min(rows, end * kBlockRows);
+      multiplyBlocked(first + first_row * depth, second,
+                      result + first_row * columns, last_row - first_row,
+                      depth, columns);
+    });
+    return;
   }
-  BigInteger tmp;
-  while (second != 0) {
-    first %= second;
-    tmp = second;
-    second = first;
-    first = tmp;
+  if (strassen_threshold != 0 && rows == depth && depth == columns) {
+    multiplyStrassen(first, rows, second, rows, result, rows, rows,
+                     strassen_threshold);
+    return;
   }
-  return first;
-}
-
-constexpr int isPrime(int number) {
-  for (int i = 2; i * i <= number; ++i) {
-    if (number % i == 0) {
-      return false;
+  forRows(pool, 0, rows, depth * columns, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      for (size_t j = 0; j < depth; ++j) {
+        for (size_t k = 0; k < columns; ++k) {
+          result[i * columns + k] += first[i * depth + j] *
+                                     second[j * columns + k];
+        }
+      }
+    }
+  });
+}
+
+template<typename Field>
+Field MatrixKernels<Field>::det(std::vector<Field> matrix, size_t size,
+                                ThreadPool* pool) {
+  if constexpr (std::is_same_v<Field, Rational>) {
+    std::vector<BigInteger> scales;
+    std::vector<std::vector<BigInteger>> rows = integerRows(matrix, size, size,
+                                                            scales);
+    bool negative;
+    if (eliminateBareiss(rows, size, false, negative, pool) != size) {
+      return 0;
+    }
+    BigInteger scale = 1;
+    for (const BigInteger& factor : scales) {
+      scale *= factor;
     }
+    Rational result(rows[size - 1][size - 1], scale);
+    return negative ? -result : result;
   }
-  return true;
-}
+  Field result = 1;
+  for (size_t i = 0; i < size; ++i) {
+    size_t non_zero = i;
+    for (size_t j = i; j < size; ++j) {
+      if (matrix[j * size + i] != 0) {
+        non_zero = j;
+        break;
+      }
+    }
 
-template<size_t N>
-class Residue {
-  size_t num_;
+    if (matrix[non_zero * size + i] == 0) {
+      return 0;
+    }
+    if (i != non_zero) {
+      std::swap_ranges(matrix.begin() + i * size,
+                       matrix.begin() + (i + 1) * size,
+                       matrix.begin() + non_zero * size);
+      result *= -1;
+    }
+    result *= matrix[i * size + i];
 
-  static Residue<N> pow(const Residue<N>& number, int exp) {
-    Residue<N> result(1);
-    for (int i = 0; i < exp; ++i) {
-      result *= number;
+    Field inverse = Field(1) / matrix[i * size + i];
+    for (size_t j = i + 1; j < size; ++j) {
+      matrix[i * size + j] *= inverse;
     }
-    return result;
+    forRows(pool, i + 1, size, size - i, [&](size_t begin, size_t end) {
+      for (size_t j = begin; j < end; ++j) {
+        for (size_t k = i + 1; k < size; ++k) {
+          matrix[j * size + k] -= matrix[j * size + i] * matrix[i * size + k];
+        }
+      }
+    });
   }
-
- public:
-  Residue() = default;
-
-  Residue(int num);
-
-  explicit operator int() const;
-
-  bool operator==(const Residue<N>& other) const;
-
-  Residue<N>& operator+=(const Residue<N>& other);
-
-  Residue<N>& operator-=(const Residue<N>& other);
-
-  Residue<N>& operator*=(const Residue<N>& other);
-
-  Residue<N>& operator/=(const Residue<N>& other);
-};
-
-template<size_t N>
-Residue<N>::Residue(int num) {
-  int res = num % static_cast<int>(N);
-  num_ = res >= 0 ? res : N + res;
-}
-
-template<size_t N>
-Residue<N>::operator int() const {
-  return num_;
-}
-
-template<size_t N>
-bool Residue<N>::operator==(const Residue<N>& other) const {
-  return num_ == other.num_;
+  return result;
 }
 
-template<size_t N>
-Residue<N>& Residue<N>::operator+=(const Residue<N>& other) {
-  num_ = (num_ + other.num_) % N;
-  return *this;
+template<typename Field>
+std::vector<Field> MatrixKernels<Field>::transposed(
+    const std::vector<Field>& matrix, size_t rows, size_t columns) {
+  std::vector<Field> result(rows * columns);
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < columns; ++j) {
+      result[j * rows + i] = matrix[i * columns + j];
+    }
+  }
+  return result;
 }
 
-template<size_t N>
-Residue<N>& Residue<N>::operator-=(const Residue<N>& other) {
-  num_ = (N + num_ - other.num_) % N;
-  return *this;
-}
+template<typename Field>
+size_t MatrixKernels<Field>::rank(std::vector<Field> matrix, size_t rows,
+                                  size_t columns, ThreadPool* pool) {
+  if constexpr (std::is_same_v<Field, Rational>) {
+    std::vector<BigInteger> scales;
+    std::vector<std::vector<BigInteger>> integer = integerRows(matrix, rows,
+                                                               columns,
+                                                               scales);
+    bool negative;
+    return eliminateBareiss(integer, columns, false, negative, pool);
+  }
+  if (rows > columns) {
+    return rank(transposed(matrix, rows, columns), columns, rows, pool);
+  }
+  size_t result = std::max(rows, columns);
+  std::vector<bool> not_used(rows, true);
+  for (size_t i = 0; i < columns; ++i) {
+    size_t non_zero = rows;
+    for (size_t j = 0; j < rows; ++j) {
+      if (not_used[j] && matrix[j * columns + i] != 0) {
+        non_zero = j;
+        break;
+      }
+    }
 
-template<size_t N>
-Residue<N>& Residue<N>::operator*=(const Residue<N>& other) {
-  num_ = (num_ * other.num_) % N;
-  return *this;
+    if (non_zero != rows) {
+      not_used[non_zero] = false;
+      Field inverse = Field(1) / matrix[non_zero * columns + i];
+      for (size_t j = i + 1; j < columns; ++j) {
+        matrix[non_zero * columns + j] *= inverse;
+      }
+      forRows(pool, 0, rows, columns - i, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) {
+          if (j != non_zero) {
+            Field factor = matrix[j * columns + i];
+            for (size_t k = i + 1; k < columns; ++k) {
+              matrix[j * columns + k] -=
+                  matrix[non_zero * columns + k] * factor;
+            }
+          }
+        }
+      });
+    } else {
+      --result;
+    }
+  }
+  return result;
 }
 
-template<size_t N>
-Residue<N>& Residue<N>::operator/=(const Residue<N>& other) {
-  static_assert(isPrime(N));
-  Residue<N> opposite = pow(other, N - 2);
-  num_ = (num_ * opposite.num_) % N;
-  return *this;
-}
+template<typename Field>
+void MatrixKernels<Field>::invert(std::vector<Field>& matrix, size_t size,
+                                  ThreadPool* pool) {
+  if constexpr (std::is_same_v<Field, Rational>) {
+    std::vector<BigInteger> scales;
+    std::vector<std::vector<BigInteger>> rows = integerRows(matrix, size, size,
+                                                            scales);
+    for (size_t i = 0; i < size; ++i) {
+      rows[i].resize(2 * size);
+      rows[i][size + i] = 1;
+    }
+    bool negative;
+    eliminateBareiss(rows, size, true, negative, pool);
+    for (size_t i = 0; i < size; ++i) {
+      for (size_t j = 0; j < size; ++j) {
+        rows[i][size + j] *= scales[j];
+        matrix[i * size + j] = Rational(rows[i][size + j], rows[i][i]);
+      }
+    }
+    return;
+  }
+  std::vector<Field> source = matrix;
+  matrix.assign(size * size, Field(0));
+  for (size_t i = 0; i < size; ++i) {
+    matrix[i * size + i] = 1;
+  }
+  for (size_t i = 0; i < size; ++i) {
+    size_t non_zero = i;
+    for (size_t j = i; j < size; ++j) {
+      if (source[j * size + i] != 0) {
+        non_zero = j;
+        break;
+      }
+    }
 
-template<size_t N>
-Residue<N> operator+(const Residue<N>& num1, const Residue<N>& num2) {
-  Residue<N> tmp(num1);
-  tmp += num2;
-  return tmp;
-}
+    if (i != non_zero) {
+      std::swap_ranges(matrix.begin() + i * size,
+                       matrix.begin() + (i + 1) * size,
+                       matrix.begin() + non_zero * size);
+      std::swap_ranges(source.begin() + i * size,
+                       source.begin() + (i + 1) * size,
+                       source.begin() + non_zero * size);
+    }
 
-template<size_t N>
-Residue<N> operator-(const Residue<N>& num1, const Residue<N>& num2) {
-  Residue<N> tmp(num1);
-  tmp -= num2;
-  return tmp;
+    Field factor = Field(1) / source[i * size + i];
+    for (size_t j = 0; j < size; ++j) {
+      matrix[i * size + j] *= factor;
+      source[i * size + j] *= factor;
+    }
+    forRows(pool, 0, size, 2 * size, [&](size_t begin, size_t end) {
+      for (size_t j = begin; j < end; ++j) {
+        if (j != i) {
+          Field row_factor = source[j * size + i];
+          for (size_t k = 0; k < size; ++k) {
+            matrix[j * size + k] -= matrix[i * size + k] * row_factor;
+            source[j * size + k] -= source[i * size + k] * row_factor;
+          }
+        }
+      }
+    });
+  }
 }
 
-template<size_t N>
-Residue<N> operator*(const Residue<N>& num1, const Residue<N>& num2) {
-  Residue<N> tmp(num1);
-  tmp *= num2;
-  return tmp;
-}
+template<typename Field>
+size_t MatrixKernels<Field>::factorize(std::vector<Field>& matrix, size_t size,
+                                       std::vector<size_t>& permutation,
+                                       std::vector<Field>& inverses,
+                                       bool& negative, ThreadPool* pool) {
+  permutation.resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    permutation[i] = i;
+  }
+  inverses.assign(size, Field(0));
+  negative = false;
+  Field tolerance = 0;
+  if constexpr (std::is_floating_point_v<Field>) {
+    for (const Field& value : matrix) {
+      tolerance = std::max(tolerance, std::abs(value));
+    }
+    tolerance *= size * std::numeric_limits<Field>::epsilon();
+  }
+  size_t rank = 0;
+  for (size_t i = 0; i < size && rank < size; ++i) {
+    size_t non_zero = rank;
+    if constexpr (std::is_floating_point_v<Field>) {
+      for (size_t j = rank + 1; j < size; ++j) {
+        if (std::abs(matrix[j * size + i]) >
+            std::abs(matrix[non_zero * size + i])) {
+          non_zero = j;
+        }
+      }
+      if (std::abs(matrix[non_zero * size + i]) <= tolerance) {
+        non_zero = size;
+      }
+    } else {
+      while (non_zero < size && matrix[non_zero * size + i] == 0) {
+        ++non_zero;
+      }
+    }
 
-template<size_t N>
-Residue<N> operator/(const Residue<N>& num1, const Residue<N>& num2) {
-  Residue<N> tmp(num1);
-  tmp /= num2;
-  return tmp;
-}
+    if (non_zero == size) {
+      continue;
+    }
+    if (non_zero != rank) {
+      std::swap_ranges(matrix.begin() + rank * size,
+                       matrix.begin() + (rank + 1) * size,
+                       matrix.begin() + non_zero * size);
+      std::swap(permutation[rank], permutation[non_zero]);
+      negative = !negative;
+    }
 
-template<size_t N>
-std::ostream& operator<<(std::ostream& os, const Residue<N>& num) {
-  os << static_cast<int>(num);
-  return os;
-}
-std::ostream& operator<<(std::ostream& os, const Rational& num) {
-  os << static_cast<double>(num);
-  return os;
+    inverses[rank] = Field(1) / matrix[rank * size + i];
+    const Field& inverse = inverses[rank];
+    forRows(pool, rank + 1, size, size - i, [&](size_t begin, size_t end) {
+      for (size_t j = begin; j < end; ++j) {
+        Field& factor = matrix[j * size + i];
+        if (factor != 0) {
+          factor *= inverse;
+          for (size_t k = i + 1; k < size; ++k) {
+            matrix[j * size + k] -= factor * matrix[rank * size + k];
+          }
+        }
+      }
+    });
+    ++rank;
+  }
+  return rank;
 }
 
 template<size_t N, size_t M, typename Field=Rational>
 class Matrix {
-  std::vector<std::vector<Field>> matrix_{N, std::vector<Field>(M)};
+  std::vector<Field> matrix_ = std::vector<Field>(N * M);
 
-  static Matrix<N, N, Field> unityMatrix();
+  template<size_t N1, size_t M1, typename Field1>
+  friend class Matrix;
+
+  friend class DynMatrix<Field>;
+
+  template<size_t N1, size_t M1, size_t K1, typename Field1>
+  friend Matrix<N1, K1, Field1> multiply(
+      const Matrix<N1, M1, Field1>& matrix1,
+      const Matrix<M1, K1, Field1>& matrix2, ThreadPool* pool,
+      size_t strassen_threshold);
 
  public:
   Matrix() = default;
 
   Matrix(std::initializer_list<std::vector<Field>> args);
 
+  explicit Matrix(const DynMatrix<Field>& other);
+
+  template<typename Expression>
+  requires(MatrixOperands<Expression, Matrix<N, M, Field>> &&
+           !std::is_same_v<Expression, Matrix<N, M, Field>>)
+  Matrix(const Expression& expression);
+
+  template<typename Expression>
+  requires(MatrixOperands<Expression, Matrix<N, M, Field>> &&
+           !std::is_same_v<Expression, Matrix<N, M, Field>>)
+  Matrix& operator=(const Expression& expression);
+
   bool operator==(const Matrix& other) const = default;
 
   Matrix& operator+=(const Matrix& other);
@@ -846,17 +1254,19 @@ class Matrix {
 
   Matrix& operator*=(const Field& factor);
 
-  Matrix& operator*=(const Matrix<M, M, Field> other);
+  Matrix& operator*=(const Matrix<M, M, Field>& other);
 
-  Field det() const;
+  Field det(ThreadPool* pool = nullptr) const;
 
   Matrix<M, N, Field> transposed() const;
 
-  size_t rank() const;
+  size_t rank(ThreadPool* pool = nullptr) const;
+
+  void invert(ThreadPool* pool = nullptr);
 
-  void invert();
+  Matrix<N, N, Field> inverted(ThreadPool* pool = nullptr) const;
 
-  Matrix<N, N, Field> inverted() const;
+  LUDecomposition<Field> lu(ThreadPool* pool = nullptr) const;
 
   Field trace() const;
 
@@ -870,29 +1280,71 @@ class Matrix {
 };
 
 template<size_t N, size_t M, typename Field>
-Matrix<N, N, Field> Matrix<N, M, Field>::unityMatrix() {
-  static_assert(N == M);
-  Matrix<N, N, Field> result;
+Matrix<N, M, Field>::Matrix(std::initializer_list<std::vector<Field>> args)
+    : matrix_() {
+  if (args.size() != N) {
+    throw std::invalid_argument("Matrix initializer row count " +
+                                std::to_string(args.size()) +
+                                " does not match " + shapeName(N, M));
+  }
+  matrix_.reserve(N * M);
+  for (const std::vector<Field>& row : args) {
+    if (row.size() != M) {
+      throw std::invalid_argument("Matrix initializer row length " +
+                                  std::to_string(row.size()) +
+                                  " does not match " + shapeName(N, M));
+    }
+    matrix_.insert(matrix_.end(), row.begin(), row.end());
+  }
+}
+
+template<size_t N, size_t M, typename Field>
+Matrix<N, M, Field>::Matrix(const DynMatrix<Field>& other) : matrix_() {
+  if (other.rows_ != N || other.columns_ != M) {
+    throw std::invalid_argument("cannot convert a " +
+                                shapeName(other.rows_, other.columns_) +
+                                " DynMatrix to a " + shapeName(N, M) +
+                                " Matrix");
+  }
+  matrix_ = other.matrix_;
+}
+
+template<size_t N, size_t M, typename Field>
+template<typename Expression>
+requires(MatrixOperands<Expression, Matrix<N, M, Field>> &&
+         !std::is_same_v<Expression, Matrix<N, M, Field>>)
+Matrix<N, M, Field>::Matrix(const Expression& expression) : matrix_() {
+  matrix_.reserve(N * M);
   for (size_t i = 0; i < N; ++i) {
-    result.matrix_[i][i] = 1;
+    for (size_t j = 0; j < M; ++j) {
+      matrix_.push_back(expression[i, j]);
+    }
   }
-  return result;
 }
 
 template<size_t N, size_t M, typename Field>
-Matrix<N, M, Field>::Matrix(std::initializer_list<std::vector<Field>> args)
-    : matrix_(args) {
+template<typename Expression>
+requires(MatrixOperands<Expression, Matrix<N, M, Field>> &&
+         !std::is_same_v<Expression, Matrix<N, M, Field>>)
+Matrix<N, M, Field>& Matrix<N, M, Field>::operator=(
+    const Expression& expression) {
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      matrix_[i * M + j] = expression[i, j];
+    }
+  }
+  return *this;
 }
 
 template<size_t N, size_t M, typename Field>
 Field& Matrix<N, M, Field>::operator[](size_t index1, size_t index2) {
-  return matrix_[index1][index2];
+  return matrix_[index1 * M + index2];
 }
 
 template<size_t N, size_t M, typename Field>
 const Field& Matrix<N, M, Field>::operator[](size_t index1,
                                              size_t index2) const {
-  return matrix_[index1][index2];
+  return matrix_[index1 * M + index2];
 }
 
 template<size_t N, size_t M, typename Field>
@@ -900,7 +1352,7 @@ Matrix<N, M, Field>& Matrix<N, M, Field>::operator+=(const Matrix<N, M,
                                                                   Field>& other) {
   for (size_t i = 0; i < N; ++i) {
     for (size_t j = 0; j < M; ++j) {
-      matrix_[i][j] += other.matrix_[i][j];
+      matrix_[i * M + j] += other.matrix_[i * M + j];
     }
   }
   return *this;
@@ -911,7 +1363,7 @@ Matrix<N, M, Field>& Matrix<N, M, Field>::operator-=(const Matrix<N, M,
                                                                   Field>& other) {
   for (size_t i = 0; i < N; ++i) {
     for (size_t j = 0; j < M; ++j) {
-      matrix_[i][j] -= other.matrix_[i][j];
+      matrix_[i * M + j] -= other.matrix_[i * M + j];
     }
   }
   return *this;
@@ -921,7 +1373,7 @@ template<size_t N, size_t M, typename Field>
 Matrix<N, M, Field>& Matrix<N, M, Field>::operator*=(const Field& factor) {
   for (size_t i = 0; i < N; ++i) {
     for (size_t j = 0; j < M; ++j) {
-      matrix_[i][j] *= factor;
+      matrix_[i * M + j] *= factor;
     }
   }
   return *this;
@@ -929,150 +1381,54 @@ Matrix<N, M, Field>& Matrix<N, M, Field>::operator*=(const Field& factor) {
 
 template<size_t N, size_t M, typename Field>
 Matrix<N, M, Field>& Matrix<N, M, Field>::operator*=(const Matrix<M, M,
-                                                                  Field> other) {
-  Matrix<N, M, Field> result;
-  for (size_t i = 0; i < N; ++i) {
-    for (size_t j = 0; j < M; ++j) {
-      for (size_t k = 0; k < M; ++k) {
-        result[i, j] += matrix_[i][k] * other[k, j];
-      }
-    }
-  }
-  *this = result;
+                                                                  Field>& other) {
+  *this = *this * other;
   return *this;
 }
 
 template<size_t N, size_t M, typename Field>
-Field Matrix<N, M, Field>::det() const {
+Field Matrix<N, M, Field>::det(ThreadPool* pool) const {
   static_assert(N == M);
-  std::vector<std::vector<Field>> matrix = matrix_;
-  Field result = 1;
-  for (size_t i = 0; i < N; ++i) {
-    size_t non_zero = i;
-    for (size_t j = i; j < N; ++j) {
-      if (matrix[j][i] != 0) {
-        non_zero = j;
-        break;
-      }
-    }
-
-    if (matrix[non_zero][i] == 0) {
-      return 0;
-    }
-    if (i != non_zero) {
-      std::swap(matrix[i], matrix[non_zero]);
-      result *= -1;
-    }
-    result *= matrix[i][i];
-
-    for (size_t j = i + 1; j < N; ++j) {
-      matrix[i][j] /= matrix[i][i];
-    }
-    for (size_t j = i + 1; j < N; ++j) {
-      for (size_t k = i + 1; k < N; ++k) {
-        matrix[j][k] -= matrix[j][i] * matrix[i][k];
-      }
-    }
-  }
-  return result;
-}
+  return MatrixKernels<Field>::det(matrix_, N, pool);
+}
 
 template<size_t N, size_t M, typename Field>
 Matrix<M, N, Field> Matrix<N, M, Field>::transposed() const {
   Matrix<M, N, Field> result;
-  for (size_t i = 0; i < N; ++i) {
-    for (size_t j = 0; j < M; ++j) {
-      result[j, i] = matrix_[i][j];
-    }
-  }
+  result.matrix_ = MatrixKernels<Field>::transposed(matrix_, N, M);
   return result;
 }
 
 template<size_t N, size_t M, typename Field>
-size_t Matrix<N, M, Field>::rank() const {
-  if (N > M) {
-    return transposed().rank();
-  }
-  std::vector<std::vector<Field>> matrix = matrix_;
-  size_t result = std::max(N, M);
-  std::vector<bool> not_used(N, true);
-  for (size_t i = 0; i < M; ++i) {
-    size_t non_zero = N;
-    for (size_t j = 0; j < N; ++j) {
-      if (not_used[j] && matrix[j][i] != 0) {
-        non_zero = j;
-        break;
-      }
-    }
-
-    if (non_zero != N) {
-      not_used[non_zero] = false;
-      for (size_t j = i + 1; j < M; ++j) {
-        matrix[non_zero][j] /= matrix[non_zero][i];
-      }
-      for (size_t j = 0; j < N; ++j) {
-        if (j != non_zero) {
-          for (size_t k = i + 1; k < M; ++k) {
-            matrix[j][k] -= matrix[non_zero][k] * matrix[j][i];
-          }
-        }
-      }
-    } else {
-      --result;
-    }
-  }
-  return result;
+size_t Matrix<N, M, Field>::rank(ThreadPool* pool) const {
+  return MatrixKernels<Field>::rank(matrix_, N, M, pool);
 }
 
 template<size_t N, size_t M, typename Field>
-void Matrix<N, M, Field>::invert() {
+void Matrix<N, M, Field>::invert(ThreadPool* pool) {
   static_assert(N == M);
-  Matrix<N, N, Field> result = *this;
-  *this = Matrix<N, N, Field>::unityMatrix();
-  for (size_t i = 0; i < N; ++i) {
-    size_t non_zero = i;
-    for (size_t j = i; j < N; ++j) {
-      if (result.matrix_[j][i] != 0) {
-        non_zero = j;
-        break;
-      }
-    }
-    
-    if (i != non_zero) {
-      std::swap(matrix_[i], matrix_[non_zero]);
-      std::swap(result.matrix_[i], result.matrix_[non_zero]);
-    }
-
-    Field factor = result.matrix_[i][i];
-    for (size_t j = 0; j < N; ++j) {
-      matrix_[i][j] /= factor;
-      result.matrix_[i][j] /= factor;
-    }
-    for (size_t j = 0; j < N; ++j) {
-      if (j != i) {
-        factor = result.matrix_[j][i];
-        for (size_t k = 0; k < N; ++k) {
-          matrix_[j][k] -= matrix_[i][k] * factor;
-          result.matrix_[j][k] -= result.matrix_[i][k] * factor;
-        }
-      }
-    }
-  }
+  MatrixKernels<Field>::invert(matrix_, N, pool);
 }
 
 template<size_t N, size_t M, typename Field>
-Matrix<N, N, Field> Matrix<N, M, Field>::inverted() const {
+Matrix<N, N, Field> Matrix<N, M, Field>::inverted(ThreadPool* pool) const {
   Matrix<N, N, Field> result(*this);
-  result.invert();
+  result.invert(pool);
   return result;
 }
 
+template<size_t N, size_t M, typename Field>
+LUDecomposition<Field> Matrix<N, M, Field>::lu(ThreadPool* pool) const {
+  static_assert(N == M);
+  return LUDecomposition<Field>(matrix_, N, pool);
+}
+
 template<size_t N, size_t M, typename Field>
 Field Matrix<N, M, Field>::trace() const {
   static_assert(N == M);
   Field result = 0;
   for (size_t i = 0; i < N; ++i) {
-    result += matrix_[i][i];
+    result += matrix_[i * M + i];
   }
   return result;
 }
@@ -1080,7 +1436,8 @@ Field Matrix<N, M, Field>::trace() const {
 template<size_t N, size_t M, typename Field>
 std::array<Field, M> Matrix<N, M, Field>::getRow(size_t index) const {
   std::array<Field, M> row;
-  std::copy(matrix_[index].begin(), matrix_[index].begin() + M, row.begin());
+  std::copy(matrix_.begin() + index * M, matrix_.begin() + (index + 1) * M,
+            row.begin());
   return row;
 }
 
@@ -1088,56 +1445,1128 @@ template<size_t N, size_t M, typename Field>
 std::array<Field, N> Matrix<N, M, Field>::getColumn(size_t index) const {
   std::array<Field, N> column;
   for (size_t i = 0; i < N; ++i) {
-    column[i] = matrix_[i][index];
+    column[i] = matrix_[i * M + index];
   }
   return column;
 }
 
 template<size_t N, size_t M, typename Field>
-Matrix<N, M, Field> operator+(const Matrix<N, M, Field>& matrix1,
-                              const Matrix<N, M, Field>& matrix2) {
-  Matrix<N, M, Field> result = matrix1;
+struct MatrixTraits<Matrix<N, M, Field>> {
+  static constexpr bool kIsMatrix = true;
+  static constexpr bool kIsExpression = false;
+  static constexpr size_t kRows = N;
+  static constexpr size_t kColumns = M;
+  using Value = Field;
+  using Operand = const Matrix<N, M, Field>&;
+  using Result = Matrix<N, M, Field>;
+};
+
+template<typename Expression>
+class MatrixExpression {
+ public:
+  static constexpr size_t kRows = MatrixTraits<Expression>::kRows;
+  static constexpr size_t kColumns = MatrixTraits<Expression>::kColumns;
+  using Value = typename MatrixTraits<Expression>::Value;
+  using Result = Matrix<kRows, kColumns, Value>;
+
+  Result eval() const;
+
+  Value det(ThreadPool* pool = nullptr) const;
+
+  Matrix<kColumns, kRows, Value> transposed() const;
+
+  size_t rank(ThreadPool* pool = nullptr) const;
+
+  Result inverted(ThreadPool* pool = nullptr) const;
+
+  LUDecomposition<Value> lu(ThreadPool* pool = nullptr) const;
+
+  Value trace() const;
+
+  std::array<Value, kColumns> getRow(size_t index) const;
+
+  std::array<Value, kRows> getColumn(size_t index) const;
+};
+
+template<typename Expression>
+typename MatrixExpression<Expression>::Result
+MatrixExpression<Expression>::eval() const {
+  return Result(static_cast<const Expression&>(*this));
+}
+
+template<typename Expression>
+typename MatrixExpression<Expression>::Value
+MatrixExpression<Expression>::det(ThreadPool* pool) const {
+  return eval().det(pool);
+}
+
+template<typename Expression>
+Matrix<MatrixExpression<Expression>::kColumns,
+       MatrixExpression<Expression>::kRows,
+       typename MatrixExpression<Expression>::Value>
+MatrixExpression<Expression>::transposed() const {
+  return eval().transposed();
+}
+
+template<typename Expression>
+size_t MatrixExpression<Expression>::rank(ThreadPool* pool) const {
+  return eval().rank(pool);
+}
+
+template<typename Expression>
+typename MatrixExpression<Expression>::Result
+MatrixExpression<Expression>::inverted(ThreadPool* pool) const {
+  return eval().inverted(pool);
+}
+
+template<typename Expression>
+LUDecomposition<typename MatrixExpression<Expression>::Value>
+MatrixExpression<Expression>::lu(ThreadPool* pool) const {
+  return eval().lu(pool);
+}
+
+template<typename Expression>
+typename MatrixExpression<Expression>::Value
+MatrixExpression<Expression>::trace() const {
+  static_assert(kRows == kColumns);
+  const Expression& expression = static_cast<const Expression&>(*this);
+  Value result = 0;
+  for (size_t i = 0; i < kRows; ++i) {
+    result += expression[i, i];
+  }
+  return result;
+}
+
+template<typename Expression>
+std::array<typename MatrixExpression<Expression>::Value,
+           MatrixExpression<Expression>::kColumns>
+MatrixExpression<Expression>::getRow(size_t index) const {
+  const Expression& expression = static_cast<const Expression&>(*this);
+  std::array<Value, kColumns> row;
+  for (size_t j = 0; j < kColumns; ++j) {
+    row[j] = expression[index, j];
+  }
+  return row;
+}
+
+template<typename Expression>
+std::array<typename MatrixExpression<Expression>::Value,
+           MatrixExpression<Expression>::kRows>
+MatrixExpression<Expression>::getColumn(size_t index) const {
+  const Expression& expression = static_cast<const Expression&>(*this);
+  std::array<Value, kRows> column;
+  for (size_t i = 0; i < kRows; ++i) {
+    column[i] = expression[i, index];
+  }
+  return column;
+}
+
+template<typename Left, typename Right, typename Operation>
+class MatrixBinaryExpression
+    : public MatrixExpression<MatrixBinaryExpression<Left, Right, Operation>> {
+  typename MatrixTraits<Left>::Operand left_;
+  typename MatrixTraits<Right>::Operand right_;
+
+ public:
+  using Value = typename MatrixTraits<Left>::Value;
+
+  MatrixBinaryExpression(const Left& left, const Right& right);
+
+  Value operator[](size_t index1, size_t index2) const;
+};
+
+template<typename Left, typename Right, typename Operation>
+struct MatrixTraits<MatrixBinaryExpression<Left, Right, Operation>> {
+  static constexpr bool kIsMatrix = true;
+  static constexpr bool kIsExpression = true;
+  static constexpr size_t kRows = MatrixTraits<Left>::kRows;
+  static constexpr size_t kColumns = MatrixTraits<Left>::kColumns;
+  using Value = typename MatrixTraits<Left>::Value;
+  using Operand = MatrixBinaryExpression<Left, Right, Operation>;
+  using Result = Matrix<kRows, kColumns, Value>;
+};
+
+template<typename Left, typename Right, typename Operation>
+MatrixBinaryExpression<Left, Right, Operation>::MatrixBinaryExpression(
+    const Left& left, const Right& right)
+    : left_(left), right_(right) {}
+
+template<typename Left, typename Right, typename Operation>
+typename MatrixBinaryExpression<Left, Right, Operation>::Value
+MatrixBinaryExpression<Left, Right, Operation>::operator[](
+    size_t index1, size_t index2) const {
+  return Operation()(left_[index1, index2], right_[index1, index2]);
+}
+
+template<typename Source>
+class MatrixScaleExpression
+    : public MatrixExpression<MatrixScaleExpression<Source>> {
+  typename MatrixTraits<Source>::Operand operand_;
+  typename MatrixTraits<Source>::Value factor_;
+
+ public:
+  using Value = typename MatrixTraits<Source>::Value;
+
+  MatrixScaleExpression(const Source& operand, const Value& factor);
+
+  Value operator[](size_t index1, size_t index2) const;
+};
+
+template<typename Source>
+struct MatrixTraits<MatrixScaleExpression<Source>> {
+  static constexpr bool kIsMatrix = true;
+  static constexpr bool kIsExpression = true;
+  static constexpr size_t kRows = MatrixTraits<Source>::kRows;
+  static constexpr size_t kColumns = MatrixTraits<Source>::kColumns;
+  using Value = typename MatrixTraits<Source>::Value;
+  using Operand = MatrixScaleExpression<Source>;
+  using Result = Matrix<kRows, kColumns, Value>;
+};
+
+template<typename Source>
+MatrixScaleExpression<Source>::MatrixScaleExpression(const Source& operand,
+                                                     const Value& factor)
+    : operand_(operand), factor_(factor) {}
+
+template<typename Source>
+typename MatrixScaleExpression<Source>::Value
+MatrixScaleExpression<Source>::operator[](size_t index1,
+                                          size_t index2) const {
+  return operand_[index1, index2] * factor_;
+}
+
+// Sums, differences and scalings are lazy: `auto x = a + b;` keeps
+// references to a and b, which must outlive x. Assign to a Matrix to
+// materialize the result.
+template<typename Left, typename Right>
+requires(MatrixOperands<Left, Right>)
+MatrixBinaryExpression<Left, Right, std::plus<>> operator+(
+    const Left& left, const Right& right) {
+  return MatrixBinaryExpression<Left, Right, std::plus<>>(left, right);
+}
+
+template<typename Left, typename Right>
+requires(MatrixOperands<Left, Right>)
+MatrixBinaryExpression<Left, Right, std::minus<>> operator-(
+    const Left& left, const Right& right) {
+  return MatrixBinaryExpression<Left, Right, std::minus<>>(left, right);
+}
+
+template<typename Source>
+requires(MatrixTraits<Source>::kIsMatrix)
+MatrixScaleExpression<Source> operator*(
+    const Source& operand,
+    const typename MatrixTraits<Source>::Value& factor) {
+  return MatrixScaleExpression<Source>(operand, factor);
+}
+
+template<typename Source>
+requires(MatrixTraits<Source>::kIsMatrix)
+MatrixScaleExpression<Source> operator*(
+    const typename MatrixTraits<Source>::Value& factor,
+    const Source& operand) {
+  return MatrixScaleExpression<Source>(operand, factor);
+}
+
+template<size_t N, size_t M, size_t K, typename Field>
+Matrix<N, K, Field> multiply(const Matrix<N, M, Field>& matrix1,
+                             const Matrix<M, K, Field>& matrix2,
+                             ThreadPool* pool, size_t strassen_threshold) {
+  Matrix<N, K, Field> result;
+  MatrixKernels<Field>::multiply(matrix1.matrix_.data(),
+                                 matrix2.matrix_.data(),
+                                 result.matrix_.data(), N, M, K,
+                                 strassen_threshold, pool);
+  return result;
+}
+
+template<size_t N, size_t M, size_t K, typename Field>
+Matrix<N, K, Field> multiply(const Matrix<N, M, Field>& matrix1,
+                             const Matrix<M, K, Field>& matrix2,
+                             ThreadPool* pool) {
+  return multiply(matrix1, matrix2, pool, 0);
+}
+
+template<size_t N, size_t M, size_t K, typename Field>
+Matrix<N, K, Field> operator*(const Matrix<N, M, Field>& matrix1,
+                              const Matrix<M, K, Field>& matrix2) {
+  return multiply(matrix1, matrix2, nullptr);
+}
+
+template<typename Left, typename Right>
+requires(MatrixProductOperands<Left, Right> &&
+         MatrixExpressionOperands<Left, Right>)
+Matrix<MatrixTraits<Left>::kRows, MatrixTraits<Right>::kColumns,
+       typename MatrixTraits<Left>::Value>
+operator*(const Left& left, const Right& right) {
+  const typename MatrixTraits<Left>::Result& first = left;
+  const typename MatrixTraits<Right>::Result& second = right;
+  return first * second;
+}
+
+template<typename Left, typename Right>
+requires(MatrixOperands<Left, Right> &&
+         MatrixExpressionOperands<Left, Right>)
+bool operator==(const Left& left, const Right& right) {
+  for (size_t i = 0; i < MatrixTraits<Left>::kRows; ++i) {
+    for (size_t j = 0; j < MatrixTraits<Left>::kColumns; ++j) {
+      if (!(left[i, j] == right[i, j])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template<size_t N, typename Field=Rational>
+using SquareMatrix = Matrix<N, N, Field>;
+
+template<typename Field=Rational>
+class DynMatrix {
+  size_t rows_ = 0;
+  size_t columns_ = 0;
+  std::vector<Field> matrix_;
+
+  template<size_t N, size_t M, typename Field1>
+  friend class Matrix;
+
+  template<typename Field1>
+  friend DynMatrix<Field1> multiply(const DynMatrix<Field1>& matrix1,
+                                    const DynMatrix<Field1>& matrix2,
+                                    ThreadPool* pool,
+                                    size_t strassen_threshold);
+
+ public:
+  DynMatrix() = default;
+
+  DynMatrix(size_t rows, size_t columns);
+
+  DynMatrix(std::initializer_list<std::vector<Field>> args);
+
+  template<size_t N, size_t M>
+  DynMatrix(const Matrix<N, M, Field>& other);
+
+  template<typename Expression>
+  requires(MatrixTraits<Expression>::kIsExpression &&
+           std::is_same_v<typename MatrixTraits<Expression>::Value, Field>)
+  DynMatrix(const Expression& expression);
+
+  bool operator==(const DynMatrix& other) const = default;
+
+  size_t rows() const;
+
+  size_t columns() const;
+
+  DynMatrix& operator+=(const DynMatrix& other);
+
+  DynMatrix& operator-=(const DynMatrix& other);
+
+  DynMatrix& operator*=(const Field& factor);
+
+  DynMatrix& operator*=(const DynMatrix& other);
+
+  Field det(ThreadPool* pool = nullptr) const;
+
+  DynMatrix transposed() const;
+
+  size_t rank(ThreadPool* pool = nullptr) const;
+
+  void invert(ThreadPool* pool = nullptr);
+
+  DynMatrix inverted(ThreadPool* pool = nullptr) const;
+
+  LUDecomposition<Field> lu(ThreadPool* pool = nullptr) const;
+
+  Field trace() const;
+
+  std::vector<Field> getRow(size_t index) const;
+
+  std::vector<Field> getColumn(size_t index) const;
+
+  Field& operator[](size_t index1, size_t index2);
+
+  const Field& operator[](size_t index1, size_t index2) const;
+};
+
+template<typename Field>
+DynMatrix<Field>::DynMatrix(size_t rows, size_t columns)
+    : rows_(rows), columns_(columns), matrix_(rows * columns) {}
+
+template<typename Field>
+DynMatrix<Field>::DynMatrix(std::initializer_list<std::vector<Field>> args)
+    : rows_(args.size()),
+      columns_(args.size() == 0 ? 0 : args.begin()->size()),
+      matrix_() {
+  matrix_.reserve(rows_ * columns_);
+  for (const std::vector<Field>& row : args) {
+    if (row.size() != columns_) {
+      throw std::invalid_argument("DynMatrix initializer row length " +
+                                  std::to_string(row.size()) +
+                                  " does not match the first row's " +
+                                  std::to_string(columns_));
+    }
+    matrix_.insert(matrix_.end(), row.begin(), row.end());
+  }
+}
+
+template<typename Field>
+template<size_t N, size_t M>
+DynMatrix<Field>::DynMatrix(const Matrix<N, M, Field>& other)
+    : rows_(N), columns_(M), matrix_(other.matrix_) {}
+
+template<typename Field>
+template<typename Expression>
+requires(MatrixTraits<Expression>::kIsExpression &&
+         std::is_same_v<typename MatrixTraits<Expression>::Value, Field>)
+DynMatrix<Field>::DynMatrix(const Expression& expression)
+    : DynMatrix(typename MatrixTraits<Expression>::Result(expression)) {}
+
+template<typename Field>
+size_t DynMatrix<Field>::rows() const {
+  return rows_;
+}
+
+template<typename Field>
+size_t DynMatrix<Field>::columns() const {
+  return columns_;
+}
+
+template<typename Field>
+Field& DynMatrix<Field>::operator[](size_t index1, size_t index2) {
+  return matrix_[index1 * columns_ + index2];
+}
+
+template<typename Field>
+const Field& DynMatrix<Field>::operator[](size_t index1,
+                                          size_t index2) const {
+  return matrix_[index1 * columns_ + index2];
+}
+
+template<typename Field>
+DynMatrix<Field>& DynMatrix<Field>::operator+=(const DynMatrix& other) {
+  if (rows_ != other.rows_ || columns_ != other.columns_) {
+    throw std::invalid_argument("DynMatrix += needs equal shapes, got " +
+                                shapeName(rows_, columns_) + " and " +
+                                shapeName(other.rows_, other.columns_));
+  }
+  for (size_t i = 0; i < matrix_.size(); ++i) {
+    matrix_[i] += other.matrix_[i];
+  }
+  return *this;
+}
+
+template<typename Field>
+DynMatrix<Field>& DynMatrix<Field>::operator-=(const DynMatrix& other) {
+  if (rows_ != other.rows_ || columns_ != other.columns_) {
+    throw std::invalid_argument("DynMatrix -= needs equal shapes, got " +
+                                shapeName(rows_, columns_) + " and " +
+                                shapeName(other.rows_, other.columns_));
+  }
+  for (size_t i = 0; i < matrix_.size(); ++i) {
+    matrix_[i] -= other.matrix_[i];
+  }
+  return *this;
+}
+
+template<typename Field>
+DynMatrix<Field>& DynMatrix<Field>::operator*=(const Field& factor) {
+  for (Field& value : matrix_) {
+    value *= factor;
+  }
+  return *this;
+}
+
+template<typename Field>
+DynMatrix<Field>& DynMatrix<Field>::operator*=(const DynMatrix& other) {
+  *this = *this * other;
+  return *this;
+}
+
+template<typename Field>
+Field DynMatrix<Field>::det(ThreadPool* pool) const {
+  if (rows_ != columns_) {
+    throw std::invalid_argument("DynMatrix::det needs a square matrix, got " +
+                                shapeName(rows_, columns_));
+  }
+  return MatrixKernels<Field>::det(matrix_, rows_, pool);
+}
+
+template<typename Field>
+DynMatrix<Field> DynMatrix<Field>::transposed() const {
+  DynMatrix<Field> result;
+  result.rows_ = columns_;
+  result.columns_ = rows_;
+  result.matrix_ = MatrixKernels<Field>::transposed(matrix_, rows_, columns_);
+  return result;
+}
+
+template<typename Field>
+size_t DynMatrix<Field>::rank(ThreadPool* pool) const {
+  return MatrixKernels<Field>::rank(matrix_, rows_, columns_, pool);
+}
+
+template<typename Field>
+void DynMatrix<Field>::invert(ThreadPool* pool) {
+  if (rows_ != columns_) {
+    throw std::invalid_argument(
+        "DynMatrix::invert needs a square matrix, got " +
+        shapeName(rows_, columns_));
+  }
+  MatrixKernels<Field>::invert(matrix_, rows_, pool);
+}
+
+template<typename Field>
+DynMatrix<Field> DynMatrix<Field>::inverted(ThreadPool* pool) const {
+  DynMatrix<Field> result(*this);
+  result.invert(pool);
+  return result;
+}
+
+template<typename Field>
+LUDecomposition<Field> DynMatrix<Field>::lu(ThreadPool* pool) const {
+  if (rows_ != columns_) {
+    throw std::invalid_argument("DynMatrix::lu needs a square matrix, got " +
+                                shapeName(rows_, columns_));
+  }
+  return LUDecomposition<Field>(matrix_, rows_, pool);
+}
+
+template<typename Field>
+Field DynMatrix<Field>::trace() const {
+  if (rows_ != columns_) {
+    throw std::invalid_argument("DynMatrix::trace needs a square matrix, got " +
+                                shapeName(rows_, columns_));
+  }
+  Field result = 0;
+  for (size_t i = 0; i < rows_; ++i) {
+    result += matrix_[i * columns_ + i];
+  }
+  return result;
+}
+
+template<typename Field>
+std::vector<Field> DynMatrix<Field>::getRow(size_t index) const {
+  return std::vector<Field>(matrix_.begin() + index * columns_,
+                            matrix_.begin() + (index + 1) * columns_);
+}
+
+template<typename Field>
+std::vector<Field> DynMatrix<Field>::getColumn(size_t index) const {
+  std::vector<Field> column(rows_);
+  for (size_t i = 0; i < rows_; ++i) {
+    column[i] = matrix_[i * columns_ + index];
+  }
+  return column;
+}
+
+template<typename Field>
+DynMatrix<Field> operator+(const DynMatrix<Field>& matrix1,
+                           const DynMatrix<Field>& matrix2) {
+  DynMatrix<Field> result = matrix1;
   result += matrix2;
   return result;
 }
 
-template<size_t N, size_t M, typename Field>
-Matrix<N, M, Field> operator-(const Matrix<N, M, Field>& matrix1,
-                              const Matrix<N, M, Field>& matrix2) {
-  Matrix<N, M, Field> result = matrix1;
+template<typename Field>
+DynMatrix<Field> operator-(const DynMatrix<Field>& matrix1,
+                           const DynMatrix<Field>& matrix2) {
+  DynMatrix<Field> result = matrix1;
   result -= matrix2;
   return result;
 }
 
-template<size_t N, size_t M, typename Field>
-Matrix<N, M, Field> operator*(const Matrix<N, M, Field>& matrix,
-                              const Field& factor) {
-  Matrix<N, M, Field> result = matrix;
+template<typename Field>
+DynMatrix<Field> operator*(const DynMatrix<Field>& matrix,
+                           const Field& factor) {
+  DynMatrix<Field> result = matrix;
   result *= factor;
   return result;
 }
 
-template<size_t N, size_t M, typename Field>
-Matrix<N, M, Field> operator*(const Field& factor,
-                              const Matrix<N, M, Field>& matrix) {
-  Matrix<N, M, Field> result = matrix;
+template<typename Field>
+DynMatrix<Field> operator*(const Field& factor,
+                           const DynMatrix<Field>& matrix) {
+  DynMatrix<Field> result = matrix;
   result *= factor;
   return result;
 }
 
-template<size_t N, size_t M, size_t K, typename Field>
-Matrix<N, K, Field> operator*(const Matrix<N, M, Field>& matrix1,
-                              const Matrix<M, K, Field>& matrix2) {
-  Matrix<N, K, Field> result;
-  for (size_t i = 0; i < N; ++i) {
-    for (size_t k = 0; k < K; ++k) {
-      for (size_t j = 0; j < M; ++j) {
-        result[i, k] += matrix1[i, j] * matrix2[j, k];
-      }
+template<typename Field>
+DynMatrix<Field> multiply(const DynMatrix<Field>& matrix1,
+                          const DynMatrix<Field>& matrix2, ThreadPool* pool,
+                          size_t strassen_threshold) {
+  if (matrix1.columns_ != matrix2.rows_) {
+    throw std::invalid_argument(
+        "cannot multiply a " + shapeName(matrix1.rows_, matrix1.columns_) +
+        " DynMatrix by a " + shapeName(matrix2.rows_, matrix2.columns_) +
+        " one");
+  }
+  DynMatrix<Field> result(matrix1.rows_, matrix2.columns_);
+  MatrixKernels<Field>::multiply(matrix1.matrix_.data(),
+                                 matrix2.matrix_.data(),
+                                 result.matrix_.data(), matrix1.rows_,
+                                 matrix1.columns_, matrix2.columns_,
+                                 strassen_threshold, pool);
+  return result;
+}
+
+template<typename Field>
+DynMatrix<Field> multiply(const DynMatrix<Field>& matrix1,
+                          const DynMatrix<Field>& matrix2, ThreadPool* pool) {
+  return multiply(matrix1, matrix2, pool, 0);
+}
+
+template<typename Field>
+DynMatrix<Field> operator*(const DynMatrix<Field>& matrix1,
+                           const DynMatrix<Field>& matrix2) {
+  return multiply(matrix1, matrix2, nullptr);
+}
+
+template<typename Field>
+class LUDecomposition {
+  size_t size_ = 0;
+  size_t rank_ = 0;
+  bool negative_ = false;
+  std::vector<Field> matrix_;
+  std::vector<size_t> permutation_;
+  std::vector<Field> inverses_;
+
+ public:
+  LUDecomposition(std::vector<Field> matrix, size_t size,
+                  ThreadPool* pool = nullptr);
+
+  size_t size() const;
+
+  size_t rank() const;
+
+  Field det() const;
+
+  std::vector<Field> solve(const std::vector<Field>& values) const;
+
+  DynMatrix<Field> inverted() const;
+};
+
+template<typename Field>
+LUDecomposition<Field>::LUDecomposition(std::vector<Field> matrix, size_t size,
+                                        ThreadPool* pool)
+    : size_(size), matrix_(std::move(matrix)) {
+  if (matrix_.size() != size_ * size_) {
+    throw std::invalid_argument("LUDecomposition needs size * size elements");
+  }
+  rank_ = MatrixKernels<Field>::factorize(matrix_, size_, permutation_,
+                                          inverses_, negative_, pool);
+}
+
+template<typename Field>
+size_t LUDecomposition<Field>::size() const {
+  return size_;
+}
+
+template<typename Field>
+size_t LUDecomposition<Field>::rank() const {
+  return rank_;
+}
+
+template<typename Field>
+Field LUDecomposition<Field>::det() const {
+  if (rank_ != size_) {
+    return 0;
+  }
+  Field result = 1;
+  for (size_t i = 0; i < size_; ++i) {
+    result *= matrix_[i * size_ + i];
+  }
+  if (negative_) {
+    result *= -1;
+  }
+  return result;
+}
+
+template<typename Field>
+std::vector<Field> LUDecomposition<Field>::solve(
+    const std::vector<Field>& values) const {
+  if (rank_ != size_) {
+    throw std::domain_error("LUDecomposition::solve on a singular " +
+                            shapeName(size_, size_) + " matrix of rank " +
+                            std::to_string(rank_));
+  }
+  if (values.size() != size_) {
+    throw std::invalid_argument("LUDecomposition::solve needs " +
+                                std::to_string(size_) + " values, got " +
+                                std::to_string(values.size()));
+  }
+  std::vector<Field> result(size_);
+  for (size_t i = 0; i < size_; ++i) {
+    result[i] = values[permutation_[i]];
+    for (size_t k = 0; k < i; ++k) {
+      result[i] -= matrix_[i * size_ + k] * result[k];
+    }
+  }
+  for (size_t i = size_; i-- > 0;) {
+    for (size_t k = i + 1; k < size_; ++k) {
+      result[i] -= matrix_[i * size_ + k] * result[k];
     }
+    result[i] *= inverses_[i];
   }
   return result;
 }
 
-template<size_t N, typename Field=Rational>
-using SquareMatrix = Matrix<N, N, Field>;
\ No newline at end of file
+template<typename Field>
+DynMatrix<Field> LUDecomposition<Field>::inverted() const {
+  DynMatrix<Field> result(size_, size_);
+  std::vector<Field> unit(size_, Field(0));
+  for (size_t j = 0; j < size_; ++j) {
+    unit[j] = 1;
+    std::vector<Field> column = solve(unit);
+    unit[j] = 0;
+    for (size_t i = 0; i < size_; ++i) {
+      result[i, j] = std::move(column[i]);
+    }
+  }
+  return result;
+}
+
+template<typename Field=Rational>
+class CooMatrix {
+  struct Entry {
+    size_t row;
+    size_t column;
+    Field value;
+  };
+
+  size_t rows_ = 0;
+  size_t columns_ = 0;
+  std::vector<Entry> entries_;
+
+  friend class SparseMatrix<Field>;
+
+ public:
+  CooMatrix(size_t rows, size_t columns);
+
+  size_t rows() const;
+
+  size_t columns() const;
+
+  size_t nonZeros() const;
+
+  void insert(size_t row, size_t column, const Field& value);
+};
+
+template<typename Field>
+CooMatrix<Field>::CooMatrix(size_t rows, size_t columns)
+    : rows_(rows), columns_(columns) {}
+
+template<typename Field>
+size_t CooMatrix<Field>::rows() const {
+  return rows_;
+}
+
+template<typename Field>
+size_t CooMatrix<Field>::columns() const {
+  return columns_;
+}
+
+template<typename Field>
+size_t CooMatrix<Field>::nonZeros() const {
+  return entries_.size();
+}
+
+template<typename Field>
+void CooMatrix<Field>::insert(size_t row, size_t column, const Field& value) {
+  if (row >= rows_ || column >= columns_) {
+    throw std::out_of_range("CooMatrix::insert index out of range");
+  }
+  if (value != 0) {
+    entries_.push_back({row, column, value});
+  }
+}
+
+class CountLists {
+  static constexpr size_t kNone = static_cast<size_t>(-1);
+
+  std::vector<size_t> heads_;
+  std::vector<size_t> next_;
+  std::vector<size_t> previous_;
+  std::vector<size_t> counts_;
+
+ public:
+  CountLists(size_t items, size_t max_count);
+
+  void assign(size_t item, size_t count);
+
+  void remove(size_t item);
+
+  size_t first(size_t count) const;
+
+  size_t next(size_t item) const;
+
+  bool end(size_t item) const;
+};
+
+CountLists::CountLists(size_t items, size_t max_count)
+    : heads_(max_count + 1, kNone), next_(items, kNone),
+      previous_(items, kNone), counts_(items, kNone) {}
+
+void CountLists::assign(size_t item, size_t count) {
+  if (counts_[item] == count) {
+    return;
+  }
+  remove(item);
+  counts_[item] = count;
+  next_[item] = heads_[count];
+  if (heads_[count] != kNone) {
+    previous_[heads_[count]] = item;
+  }
+  heads_[count] = item;
+}
+
+void CountLists::remove(size_t item) {
+  if (counts_[item] == kNone) {
+    return;
+  }
+  if (previous_[item] != kNone) {
+    next_[previous_[item]] = next_[item];
+  } else {
+    heads_[counts_[item]] = next_[item];
+  }
+  if (next_[item] != kNone) {
+    previous_[next_[item]] = previous_[item];
+  }
+  next_[item] = kNone;
+  previous_[item] = kNone;
+  counts_[item] = kNone;
+}
+
+size_t CountLists::first(size_t count) const {
+  return count < heads_.size() ? heads_[count] : kNone;
+}
+
+size_t CountLists::next(size_t item) const {
+  return next_[item];
+}
+
+bool CountLists::end(size_t item) const {
+  return item == kNone;
+}
+
+template<typename Field=Rational>
+class SparseMatrix {
+  static constexpr size_t kMarkowitzSearch = 4;
+
+  size_t rows_ = 0;
+  size_t columns_ = 0;
+  std::vector<size_t> offsets_ = std::vector<size_t>(1, 0);
+  std::vector<size_t> indices_;
+  std::vector<Field> values_;
+
+  size_t eliminate(Field& product) const;
+
+  template<typename Field1>
+  friend DynMatrix<Field1> operator*(const SparseMatrix<Field1>& matrix1,
+                                     const DynMatrix<Field1>& matrix2);
+
+ public:
+  SparseMatrix() = default;
+
+  explicit SparseMatrix(const CooMatrix<Field>& other);
+
+  explicit SparseMatrix(const DynMatrix<Field>& other);
+
+  size_t rows() const;
+
+  size_t columns() const;
+
+  size_t nonZeros() const;
+
+  Field det() const;
+
+  size_t rank() const;
+
+  Field operator[](size_t index1, size_t index2) const;
+};
+
+template<typename Field>
+SparseMatrix<Field>::SparseMatrix(const CooMatrix<Field>& other)
+    : rows_(other.rows_), columns_(other.columns_),
+      offsets_(other.rows_ + 1, 0) {
+  std::vector<size_t> order(other.entries_.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t first, size_t second) {
+    const auto& left = other.entries_[first];
+    const auto& right = other.entries_[second];
+    return left.row != right.row ? left.row < right.row
+                                 : left.column < right.column;
+  });
+  indices_.reserve(order.size());
+  values_.reserve(order.size());
+  for (size_t i = 0; i < order.size();) {
+    const auto& entry = other.entries_[order[i]];
+    Field value = entry.value;
+    size_t j = i + 1;
+    while (j < order.size() && other.entries_[order[j]].row == entry.row &&
+           other.entries_[order[j]].column == entry.column) {
+      value += other.entries_[order[j]].value;
+      ++j;
+    }
+    if (value != 0) {
+      indices_.push_back(entry.column);
+      values_.push_back(std::move(value));
+      ++offsets_[entry.row + 1];
+    }
+    i = j;
+  }
+  for (size_t i = 0; i < rows_; ++i) {
+    offsets_[i + 1] += offsets_[i];
+  }
+}
+
+template<typename Field>
+SparseMatrix<Field>::SparseMatrix(const DynMatrix<Field>& other)
+    : rows_(other.rows()), columns_(other.columns()), offsets_(1, 0) {
+  offsets_.reserve(rows_ + 1);
+  for (size_t i = 0; i < rows_; ++i) {
+    for (size_t j = 0; j < columns_; ++j) {
+      if (other[i, j] != 0) {
+        indices_.push_back(j);
+        values_.push_back(other[i, j]);
+      }
+    }
+    offsets_.push_back(indices_.size());
+  }
+}
+
+template<typename Field>
+size_t SparseMatrix<Field>::rows() const {
+  return rows_;
+}
+
+template<typename Field>
+size_t SparseMatrix<Field>::columns() const {
+  return columns_;
+}
+
+template<typename Field>
+size_t SparseMatrix<Field>::nonZeros() const {
+  return values_.size();
+}
+
+template<typename Field>
+Field SparseMatrix<Field>::operator[](size_t index1, size_t index2) const {
+  auto begin = indices_.begin() + offsets_[index1];
+  auto end = indices_.begin() + offsets_[index1 + 1];
+  auto found = std::lower_bound(begin, end, index2);
+  if (found == end || *found != index2) {
+    return 0;
+  }
+  return values_[found - indices_.begin()];
+}
+
+template<typename Field>
+size_t SparseMatrix<Field>::eliminate(Field& product) const {
+  using Row = std::vector<std::pair<size_t, Field>>;
+  std::vector<Row> matrix(rows_);
+  std::vector<size_t> column_counts(columns_, 0);
+  std::vector<std::vector<size_t>> column_rows(columns_);
+  for (size_t i = 0; i < rows_; ++i) {
+    matrix[i].reserve(offsets_[i + 1] - offsets_[i]);
+    for (size_t k = offsets_[i]; k < offsets_[i + 1]; ++k) {
+      matrix[i].emplace_back(indices_[k], values_[k]);
+      ++column_counts[indices_[k]];
+      column_rows[indices_[k]].push_back(i);
+    }
+  }
+
+  CountLists row_lists(rows_, columns_);
+  CountLists column_lists(columns_, rows_);
+  for (size_t i = 0; i < rows_; ++i) {
+    row_lists.assign(i, matrix[i].size());
+  }
+  for (size_t j = 0; j < columns_; ++j) {
+    column_lists.assign(j, column_counts[j]);
+  }
+  auto find_entry = [](const Row& row, size_t column) {
+    return std::lower_bound(
+        row.begin(), row.end(), column,
+        [](const auto& entry, size_t index) { return entry.first < index; });
+  };
+
+  std::vector<bool> active(rows_, true);
+  std::vector<size_t> pivot_columns(rows_, columns_);
+  Row merged;
+  size_t rank = 0;
+  product = 1;
+  while (rank < rows_ && rank < columns_) {
+    size_t best_row = rows_;
+    size_t best_index = 0;
+    size_t best_cost = static_cast<size_t>(-1);
+    size_t searched = 0;
+    auto done = [&](size_t count) {
+      ++searched;
+      return best_cost <= (count - 1) * (count - 1) ||
+             (searched >= kMarkowitzSearch && best_row != rows_);
+    };
+    size_t limit = std::max(rows_, columns_);
+    bool stop = false;
+    for (size_t count = 1; count <= limit && !stop; ++count) {
+      for (size_t i = row_lists.first(count); !row_lists.end(i) && !stop;
+           i = row_lists.next(i)) {
+        for (size_t k = 0; k < count; ++k) {
+          size_t cost =
+              (count - 1) * (column_counts[matrix[i][k].first] - 1);
+          if (cost < best_cost) {
+            best_cost = cost;
+            best_row = i;
+            best_index = k;
+          }
+        }
+        stop = done(count);
+      }
+      for (size_t j = column_lists.first(count); !column_lists.end(j) && !stop;
+           j = column_lists.next(j)) {
+        std::vector<size_t>& candidates = column_rows[j];
+        size_t kept = 0;
+        for (size_t i : candidates) {
+          if (!active[i]) {
+            continue;
+          }
+          auto found = find_entry(matrix[i], j);
+          if (found == matrix[i].end() || found->first != j) {
+            continue;
+          }
+          candidates[kept++] = i;
+          size_t cost = (matrix[i].size() - 1) * (count - 1);
+          if (cost < best_cost) {
+            best_cost = cost;
+            best_row = i;
+            best_index = found - matrix[i].begin();
+          }
+        }
+        candidates.resize(kept);
+        stop = done(count);
+      }
+    }
+    if (best_row == rows_) {
+      break;
+    }
+
+    const Row& pivot = matrix[best_row];
+    size_t column = pivot[best_index].first;
+    product *= pivot[best_index].second;
+    Field inverse = Field(1) / pivot[best_index].second;
+    active[best_row] = false;
+    row_lists.remove(best_row);
+    pivot_columns[best_row] = column;
+    for (const auto& entry : pivot) {
+      --column_counts[entry.first];
+      column_lists.assign(entry.first, column_counts[entry.first]);
+    }
+
+    for (size_t i : column_rows[column]) {
+      if (!active[i]) {
+        continue;
+      }
+      Row& row = matrix[i];
+      auto found = find_entry(row, column);
+      if (found == row.end() || found->first != column) {
+        continue;
+      }
+      Field factor = found->second * inverse;
+      merged.clear();
+      size_t first = 0;
+      size_t second = 0;
+      while (first < row.size() || second < pivot.size()) {
+        size_t left = first < row.size() ? row[first].first : columns_;
+        size_t right = second < pivot.size() ? pivot[second].first : columns_;
+        if (left < right) {
+          merged.push_back(std::move(row[first++]));
+        } else if (right < left) {
+          Field value = 0;
+          value -= factor * pivot[second].second;
+          merged.emplace_back(right, std::move(value));
+          ++column_counts[right];
+          column_lists.assign(right, column_counts[right]);
+          column_rows[right].push_back(i);
+          ++second;
+        } else {
+          if (left != column) {
+            row[first].second -= factor * pivot[second].second;
+            if (row[first].second != 0) {
+              merged.push_back(std::move(row[first]));
+            } else {
+              --column_counts[left];
+              column_lists.assign(left, column_counts[left]);
+            }
+          } else {
+            --column_counts[left];
+            column_lists.assign(left, column_counts[left]);
+          }
+          ++first;
+          ++second;
+        }
+      }
+      row.swap(merged);
+      row_lists.assign(i, row.size());
+    }
+    column_rows[column].clear();
+    ++rank;
+  }
+
+  if (rank == rows_ && rank == columns_) {
+    std::vector<bool> visited(rows_, false);
+    for (size_t i = 0; i < rows_; ++i) {
+      size_t length = 0;
+      for (size_t j = i; !visited[j]; j = pivot_columns[j]) {
+        visited[j] = true;
+        ++length;
+      }
+      if (length % 2 == 0 && length != 0) {
+        product *= -1;
+      }
+    }
+  }
+  return rank;
+}
+
+template<typename Field>
+Field SparseMatrix<Field>::det() const {
+  if (rows_ != columns_) {
+    throw std::invalid_argument(
+        "SparseMatrix::det needs a square matrix, got " +
+        shapeName(rows_, columns_));
+  }
+  Field product;
+  if (eliminate(product) != rows_) {
+    return 0;
+  }
+  return product;
+}
+
+template<typename Field>
+size_t SparseMatrix<Field>::rank() const {
+  Field product;
+  return eliminate(product);
+}
+
+template<typename Field>
+DynMatrix<Field> operator*(const SparseMatrix<Field>& matrix1,
+                           const DynMatrix<Field>& matrix2) {
+  if (matrix1.columns_ != matrix2.rows()) {
+    throw std::invalid_argument(
+        "cannot multiply a " + shapeName(matrix1.rows_, matrix1.columns_) +
+        " SparseMatrix by a " + shapeName(matrix2.rows(), matrix2.columns()) +
+        " DynMatrix");
+  }
+  DynMatrix<Field> result(matrix1.rows_, matrix2.columns());
+  for (size_t i = 0; i < matrix1.rows_; ++i) {
+    for (size_t k = matrix1.offsets_[i]; k < matrix1.offsets_[i + 1]; ++k) {
+      const Field& factor = matrix1.values_[k];
+      size_t row = matrix1.indices_[k];
+      for (size_t j = 0; j < matrix2.columns(); ++j) {
+        result[i, j] += factor * matrix2[row, j];
+      }
+    }
+  }
+  return result;
+}
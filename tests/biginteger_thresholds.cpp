@@ -0,0 +1,181 @@
+#include <cassert>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../biginteger.h"
+
+// Operands on both sides of each tuning threshold must give the same
+// results as a schoolbook reference, and so must every value of the public
+// thresholds, including the degenerate ones.
+//   g++ -std=c++20 -O2 -pthread biginteger_thresholds.cpp
+//   g++ -std=c++20 -O2 -pthread -DBIGINTEGER_BINARY_LIMBS biginteger_thresholds.cpp
+
+std::string randomDigits(size_t length, std::mt19937& rng) {
+  std::string digits(1, static_cast<char>('1' + rng() % 9));
+  while (digits.size() < length) {
+    digits += static_cast<char>('0' + rng() % 10);
+  }
+  return digits;
+}
+
+// Horner over 9-digit chunks of the second operand. Every product has a
+// one-limb factor, so only the schoolbook tier runs.
+BigInteger multiplySchoolbook(const BigInteger& first,
+                              const std::string& second) {
+  BigInteger result;
+  size_t head = second.size() % 9 == 0 ? 9 : second.size() % 9;
+  for (size_t i = 0; i < second.size(); i += i == 0 ? head : 9) {
+    size_t length = i == 0 ? head : 9;
+    result *= BigInteger(1'000'000'000);
+    result += first * BigInteger(std::stoi(second.substr(i, length)));
+  }
+  return result;
+}
+
+void testMultiplyTiers() {
+  std::mt19937 rng(1);
+  for (size_t length : {5, 200, 700, 3000, 9000}) {
+    std::string first = randomDigits(length + length / 8, rng);
+    std::string second = randomDigits(length, rng);
+    BigInteger expected = multiplySchoolbook(BigInteger(first), second);
+    assert(BigInteger(first) * BigInteger(second) == expected);
+    assert(BigInteger(second) * BigInteger(first) == expected);
+  }
+}
+
+// Divisors of 20000 digits with 45000-digit dividends are above the Newton
+// threshold in both limb modes; the products behind the checks run on the
+// NTT.
+void testDivideTiers() {
+  std::mt19937 rng(3);
+  for (size_t length : {30, 3000, 20000}) {
+    BigInteger dividend(randomDigits(2 * length + 5000, rng));
+    BigInteger divisor(randomDigits(length, rng));
+    for (int signs = 0; signs < 4; ++signs) {
+      BigInteger first = signs % 2 == 0 ? dividend : -dividend;
+      BigInteger second = signs / 2 == 0 ? divisor : -divisor;
+      BigInteger quotient = first / second;
+      BigInteger remainder = first % second;
+      assert(quotient * second + remainder == first);
+      BigInteger magnitude = remainder < 0 ? -remainder : remainder;
+      assert(magnitude < divisor);
+      assert(remainder == 0 || (remainder < 0) == (first < 0));
+    }
+  }
+}
+
+void testMultiplyThresholds() {
+  std::mt19937 rng(4);
+  BigInteger first(randomDigits(700, rng));
+  BigInteger second(randomDigits(650, rng));
+  BigInteger expected = first * second;
+  for (size_t karatsuba : {0, 1, 2, 3, 40}) {
+    for (size_t toom3 : {0, 1, 2, 5, 300}) {
+      for (size_t ntt : {0, 1, 800}) {
+        BigInteger::karatsuba_threshold = karatsuba;
+        BigInteger::toom3_threshold = toom3;
+        BigInteger::ntt_threshold = ntt;
+        assert(first * second == expected);
+      }
+    }
+  }
+  BigInteger::karatsuba_threshold = 40;
+  BigInteger::toom3_threshold = 300;
+  BigInteger::ntt_threshold = 800;
+}
+
+void testConversionThresholds() {
+  std::mt19937 rng(2);
+  for (size_t length : {1, 9, 10, 18, 19, 100, 1000, 5000}) {
+    std::string digits = randomDigits(length, rng);
+    for (size_t threshold : {0, 1, 2, 3, 30}) {
+      BigInteger::conversion_threshold = threshold;
+      BigInteger::conversion_newton_threshold = threshold;
+      std::ostringstream out;
+      out << BigInteger(digits);
+      assert(out.str() == digits);
+      assert(BigInteger(digits) == BigInteger(digits + "0") / 10);
+    }
+  }
+  BigInteger::conversion_threshold = 30;
+  BigInteger::conversion_newton_threshold = 300;
+}
+
+BigInteger powerOfTwo(size_t exponent) {
+  BigInteger result = 1;
+  for (size_t i = 0; i < exponent; ++i) {
+    result *= 2;
+  }
+  return result;
+}
+
+// All-ones values fill every bit of a 32-bit limb, and 2^k + 1 divisors get
+// the largest Knuth D normalization factor; both leave no headroom for
+// carries, quotient digits or Lehmer cofactors.
+void testFullLimbs() {
+  BigInteger max64 = powerOfTwo(64) - 1;
+  assert(max64.toString() == "18446744073709551615");
+  assert((max64 * max64).toString() ==
+         "340282366920938463426481119284349108225");
+  assert((max64 / BigInteger(2147483647)).toString() == "8589934596");
+  assert(max64 % BigInteger(2147483647) == 3);
+  BigInteger prime("4294967291");
+  assert((max64 / prime).toString() == "4294967301");
+  assert((max64 % prime).toString() == "24");
+  BigInteger max96 = powerOfTwo(96) - 1;
+  assert(max96 / (powerOfTwo(64) + 1) == powerOfTwo(32) - 1);
+  assert((max96 % (powerOfTwo(64) + 1)).toString() ==
+         "18446744069414584320");
+
+  for (size_t first_bits : {96, 160, 1000, 3072, 12000}) {
+    for (size_t second_bits : {64, 100, 960, 1536, 6000}) {
+      BigInteger first = powerOfTwo(first_bits) - 1;
+      BigInteger second = powerOfTwo(second_bits) - 1;
+      assert(BigInteger::gcd(first, second) ==
+             powerOfTwo(std::gcd(first_bits, second_bits)) - 1);
+      for (const BigInteger& divisor : {second, second + 2}) {
+        BigInteger quotient = first / divisor;
+        BigInteger remainder = first % divisor;
+        assert(quotient * divisor + remainder == first);
+        assert(remainder >= 0 && remainder < divisor);
+      }
+    }
+  }
+}
+
+// Threads converting at once grow the shared power and reciprocal caches
+// together; every round trip must still be exact.
+void testConcurrentConversion() {
+  std::vector<std::string> inputs;
+  std::mt19937 rng(5);
+  for (size_t length : {2000, 9000, 30000, 60000}) {
+    inputs.push_back(randomDigits(length, rng));
+  }
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&inputs, i] {
+      for (size_t j = 0; j < inputs.size(); ++j) {
+        const std::string& digits = inputs[(i + j) % inputs.size()];
+        assert(BigInteger(digits).toString() == digits);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+int main() {
+  testConcurrentConversion();
+  testMultiplyTiers();
+  testMultiplyThresholds();
+  testDivideTiers();
+  testConversionThresholds();
+  testFullLimbs();
+  std::puts("ok");
+}
@@ -0,0 +1,79 @@
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+
+#include "../matrix.h"
+#include "rejects.h"
+
+// DynMatrix operations must reject operands whose shapes do not match.
+//   g++ -std=c++23 -O2 matrix_dynamic.cpp
+
+const DynMatrix<Rational> square = {{1, 2}, {3, 4}};
+const DynMatrix<Rational> wide = {{1, 2, 3}, {4, 5, 6}};
+const DynMatrix<Rational> tall = {{1, 2}, {3, 4}, {5, 6}};
+
+void testConversion() {
+  Matrix<2, 3, Rational> fixed(wide);
+  assert(DynMatrix<Rational>(fixed) == wide);
+  assert(rejects<std::invalid_argument>(
+      [] { Matrix<3, 2, Rational> wrong(wide); }, "2x3 DynMatrix to a 3x2"));
+  assert(rejects<std::invalid_argument>(
+      [] { Matrix<2, 2, Rational> wrong(wide); }));
+}
+
+void testArithmetic() {
+  assert(square + square == square * Rational(2));
+  assert((square * wide).rows() == 2 && (square * wide).columns() == 3);
+  assert((wide * tall).rows() == 2 && (wide * tall).columns() == 2);
+
+  assert(rejects<std::invalid_argument>([] { return square + wide; },
+                                        "got 2x2 and 2x3"));
+  assert(rejects<std::invalid_argument>([] { return wide - tall; }));
+  assert(rejects<std::invalid_argument>([] { return wide * square; },
+                                        "2x3 DynMatrix by a 2x2"));
+  assert(rejects<std::invalid_argument>([] {
+    DynMatrix<Rational> result = square;
+    result += tall;
+  }));
+  assert(rejects<std::invalid_argument>([] {
+    DynMatrix<Rational> result = square;
+    result -= wide;
+  }));
+  assert(rejects<std::invalid_argument>([] {
+    DynMatrix<Rational> result = wide;
+    result *= wide;
+  }));
+}
+
+void testSquareOnly() {
+  assert(square.det() == Rational(-2));
+  assert(rejects<std::invalid_argument>([] { return wide.det(); },
+                                        "det needs a square matrix, got 2x3"));
+  assert(rejects<std::invalid_argument>([] { return tall.inverted(); }));
+  assert(rejects<std::invalid_argument>([] { return wide.lu(); }));
+  assert(square.trace() == Rational(5));
+  assert(rejects<std::invalid_argument>([] { return tall.trace(); }));
+}
+
+void testRaggedRows() {
+  assert(rejects<std::invalid_argument>(
+      [] { return DynMatrix<double>{{1, 2}, {3}}; },
+      "row length 1 does not match the first row's 2"));
+  assert(rejects<std::invalid_argument>(
+      [] { return DynMatrix<double>{{1}, {2, 3}}; }));
+  assert(rejects<std::invalid_argument>(
+      [] { return Matrix<2, 2, double>{{1, 2}, {3}}; }));
+  assert(rejects<std::invalid_argument>(
+      [] { return Matrix<2, 2, double>{{1, 2}}; },
+      "row count 1 does not match 2x2"));
+  assert(rejects<std::invalid_argument>(
+      [] { return Matrix<2, 2, double>{{1, 2}, {3, 4}, {5, 6}}; }));
+}
+
+int main() {
+  testConversion();
+  testArithmetic();
+  testSquareOnly();
+  testRaggedRows();
+  std::puts("ok");
+}
@@ -0,0 +1,70 @@
+#include <cassert>
+#include <cstdio>
+#include <type_traits>
+
+#include "../matrix.h"
+
+// Lazy sums and scalings must work wherever a Matrix did, and must hand out
+// element values rather than references into their operands.
+//   g++ -std=c++23 -O2 matrix_expression.cpp
+
+template<typename Type>
+concept WritableElements = requires(Type matrix) {
+  matrix[0, 0] = typename MatrixTraits<Type>::Value(1);
+};
+
+using Square = Matrix<3, 3, Rational>;
+
+const Square a = {{2, 0, 1}, {1, 3, 2}, {1, 1, 1}};
+const Square b = {{1, 2, 0}, {0, 1, 4}, {5, 0, 1}};
+const Square c = {{1, 0, 0}, {2, 1, 0}, {0, 3, 1}};
+
+void testProducts() {
+  Square sum = a + b;
+  Square difference = a - b;
+  assert((a + b) * c == sum * c);
+  assert(c * (a - b) == c * difference);
+  assert((a + b) * (a - b) == sum * difference);
+  assert((a * Rational(2)) * c == (a + a) * c);
+
+  Matrix<3, 2, Rational> tall = {{1, 2}, {3, 4}, {5, 6}};
+  assert((a + b) * tall == sum * tall);
+}
+
+void testMembers() {
+  Square sum = a + b;
+  Square difference = a - b;
+  assert((a + b).det() == sum.det());
+  assert((a - b).trace() == difference.trace());
+  assert((a + b).transposed() == sum.transposed());
+  assert((a - b).rank() == difference.rank());
+  assert((a + b).inverted() == sum.inverted());
+  assert((a + b).lu().det() == sum.det());
+  assert((a + b).getRow(1) == sum.getRow(1));
+  assert((a - b).getColumn(2) == difference.getColumn(2));
+  assert((Rational(3) * a).eval() == a + a + a);
+}
+
+void testConversions() {
+  Square result = a;
+  result += a + b;
+  assert(result == a + a + b);
+  result *= a - b;
+  assert(result == (a + a + b) * (a - b));
+  assert(a + b == b + a);
+  assert(!(a + b != b + a));
+
+  DynMatrix<Rational> dynamic = a + b;
+  assert(Square(dynamic) == a + b);
+}
+
+static_assert(WritableElements<Square>);
+static_assert(std::is_same_v<decltype((a + b)[0, 0]), Rational>);
+static_assert(std::is_same_v<decltype((a * Rational(2))[0, 0]), Rational>);
+
+int main() {
+  testProducts();
+  testMembers();
+  testConversions();
+  std::puts("ok");
+}
@@ -0,0 +1,77 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#include "../matrix.h"
+#include "rejects.h"
+
+// LU factorization: partial pivoting keeps floating-point solves accurate,
+// singular matrices are reported instead of solved, and buffers that are
+// not size * size are rejected.
+//   g++ -std=c++23 -O2 matrix_lu.cpp
+
+void testSmallLeadingPivot() {
+  Matrix<2, 2, double> matrix = {{1e-20, 1}, {1, 1}};
+  std::vector<double> solution = matrix.lu().solve({1, 2});
+  assert(std::abs(solution[0] - 1) < 1e-12);
+  assert(std::abs(solution[1] - 1) < 1e-12);
+  assert(std::abs(matrix.lu().det() + 1) < 1e-12);
+}
+
+void testHilbert() {
+  const size_t size = 8;
+  DynMatrix<double> hilbert(size, size);
+  std::vector<double> values(size, 0);
+  for (size_t i = 0; i < size; ++i) {
+    for (size_t j = 0; j < size; ++j) {
+      hilbert[i, j] = 1.0 / (i + j + 1);
+      values[i] += hilbert[i, j];
+    }
+  }
+  std::vector<double> solution = hilbert.lu().solve(values);
+  for (double value : solution) {
+    assert(std::abs(value - 1) < 1e-4);
+  }
+}
+
+void testSingular() {
+  Matrix<3, 3, Rational> exact = {{1, 2, 3}, {2, 4, 6}, {1, 0, 1}};
+  LUDecomposition<Rational> exact_lu = exact.lu();
+  assert(exact_lu.rank() == 2);
+  assert(exact_lu.det() == Rational(0));
+  assert(rejects<std::domain_error>([&] { return exact_lu.solve({1, 2, 3}); },
+                                    "singular 3x3 matrix of rank 2"));
+  assert(rejects<std::domain_error>([&] { return exact_lu.inverted(); }));
+
+  Matrix<3, 3, double> rounded = {{0.1, 0.2, 0.3},
+                                  {0.3, 0.6, 0.9},
+                                  {0.7, 0.1, 0.5}};
+  LUDecomposition<double> rounded_lu = rounded.lu();
+  assert(rounded_lu.rank() == 2);
+  assert(rounded_lu.det() == 0);
+  assert(rejects<std::domain_error>(
+      [&] { return rounded_lu.solve({1, 2, 3}); }));
+}
+
+void testWrongSize() {
+  std::vector<Rational> values = {1, 2, 3, 4, 5};
+  assert(rejects<std::invalid_argument>(
+      [&] { return LUDecomposition<Rational>(values, 2); }));
+  assert(rejects<std::invalid_argument>(
+      [&] { return LUDecomposition<Rational>(values, 3); }));
+  values.pop_back();
+  LUDecomposition<Rational> lu(values, 2);
+  assert(lu.det() == Rational(-2));
+  assert(rejects<std::invalid_argument>([&] { return lu.solve({1, 2, 3}); },
+                                        "needs 2 values, got 3"));
+}
+
+int main() {
+  testSmallLeadingPivot();
+  testHilbert();
+  testSingular();
+  testWrongSize();
+  std::puts("ok");
+}
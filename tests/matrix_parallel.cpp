@@ -0,0 +1,98 @@
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include "../matrix.h"
+
+// Kernels given a ThreadPool must return exactly the sequential results,
+// independent callers may use their own pools at the same time, and an
+// exception from any chunk reaches the caller once every chunk has finished.
+//   g++ -std=c++23 -O2 -pthread matrix_parallel.cpp
+
+template<typename Field>
+DynMatrix<Field> randomMatrix(size_t size, unsigned seed) {
+  std::mt19937 rng(seed);
+  DynMatrix<Field> matrix(size, size);
+  for (size_t i = 0; i < size; ++i) {
+    for (size_t j = 0; j < size; ++j) {
+      matrix[i, j] = Field(static_cast<int>(rng() % 2001) - 1000);
+    }
+  }
+  return matrix;
+}
+
+template<typename Field>
+void compareWithSequential(size_t size, ThreadPool& pool) {
+  DynMatrix<Field> first = randomMatrix<Field>(size, 1);
+  DynMatrix<Field> second = randomMatrix<Field>(size, 2);
+  assert(multiply(first, second, &pool) == first * second);
+  assert(first.det(&pool) == first.det());
+  assert(first.rank(&pool) == first.rank());
+  assert(first.inverted(&pool) == first.inverted());
+  assert(first.lu(&pool).solve(second.getRow(0)) ==
+         first.lu().solve(second.getRow(0)));
+}
+
+void testDeterministic() {
+  ThreadPool pool(4);
+  compareWithSequential<Residue<1000003>>(96, pool);
+  compareWithSequential<double>(160, pool);
+  compareWithSequential<Rational>(16, pool);
+
+  Matrix<3, 3, Rational> fixed = {{2, 0, 1}, {1, 3, 2}, {1, 1, 1}};
+  assert(multiply(fixed, fixed, &pool) == fixed * fixed);
+  assert(fixed.inverted(&pool) == fixed.inverted());
+
+  DynMatrix<Residue<1000003>> square = randomMatrix<Residue<1000003>>(96, 4);
+  assert(multiply(square, square, &pool, 16) == square * square);
+  assert(multiply(fixed, fixed, nullptr, 2) == fixed * fixed);
+}
+
+void testIndependentPools() {
+  DynMatrix<Residue<1000003>> matrix = randomMatrix<Residue<1000003>>(96, 3);
+  Residue<1000003> expected = matrix.det();
+  bool first_ok = false;
+  bool second_ok = false;
+  std::thread first([&] {
+    ThreadPool pool(2);
+    first_ok = matrix.det(&pool) == expected;
+  });
+  std::thread second([&] {
+    ThreadPool pool(3);
+    second_ok = matrix.det(&pool) == expected && matrix.det() == expected;
+  });
+  first.join();
+  second.join();
+  assert(first_ok && second_ok);
+}
+
+void testExceptions() {
+  ThreadPool pool(4);
+  for (size_t failing = 0; failing < 64; failing += 7) {
+    std::atomic<size_t> visited = 0;
+    bool caught = false;
+    try {
+      pool.parallelFor(0, 64, [&](size_t first, size_t last) {
+        visited += last - first;
+        if (first <= failing && failing < last) {
+          throw std::runtime_error("");
+        }
+      });
+    } catch (const std::runtime_error&) {
+      caught = true;
+    }
+    assert(caught && visited == 64);
+  }
+  DynMatrix<Residue<1000003>> matrix = randomMatrix<Residue<1000003>>(48, 5);
+  assert(matrix.det(&pool) == matrix.det());
+}
+
+int main() {
+  testDeterministic();
+  testIndependentPools();
+  testExceptions();
+  std::puts("ok");
+}
@@ -0,0 +1,93 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "../matrix.h"
+
+// Primality check behind Residue<N> and basic Residue arithmetic.
+//   g++ -std=c++23 -O2 matrix_residue.cpp
+
+void testPrimes() {
+  const uint64_t primes[] = {2, 3, 37, 41, 1000003, 998244353,
+                             (uint64_t(1) << 61) - 1,
+                             18446744073709551557ULL};
+  for (uint64_t prime : primes) {
+    assert(isPrime(prime));
+  }
+  static_assert(isPrime(1000000007));
+}
+
+void testStrongPseudoprimes() {
+  const uint64_t composites[] = {0, 1, 4, 561, 2047, 1373653, 25326001,
+                                 56052361, 3215031751, 341550071728321,
+                                 3825123056546413051ULL,
+                                 uint64_t(1000003) * 1000033};
+  for (uint64_t composite : composites) {
+    assert(!isPrime(composite));
+  }
+  static_assert(!isPrime(56052361));
+}
+
+void testArithmetic() {
+  Residue<1000003> a(123456);
+  Residue<1000003> b(-7);
+  assert(a * a.inverse() == Residue<1000003>(1));
+  assert(a + b == Residue<1000003>(123449));
+  assert(b == Residue<1000003>(999996));
+}
+
+template<uint64_t N>
+void checkBatchInvert() {
+  std::vector<Residue<N>> values;
+  for (int value : {1, 2, 3, 0, 12345, -1, 999983, -77777, 0, 65537}) {
+    values.emplace_back(value);
+  }
+  std::vector<Residue<N>> inverted = values;
+  Residue<N>::batchInvert(inverted);
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (values[i] == 0) {
+      assert(inverted[i] == 0);
+    } else {
+      assert(values[i] * inverted[i] == Residue<N>(1));
+      assert(inverted[i] == values[i].inverse());
+    }
+  }
+}
+
+void testBatchInvert() {
+  checkBatchInvert<1000003>();
+  checkBatchInvert<998244353>();
+  checkBatchInvert<4294967291>();
+  checkBatchInvert<4294967311>();
+  checkBatchInvert<(uint64_t(1) << 61) - 1>();
+}
+
+void testLargeModulus() {
+  const uint64_t modulus = (uint64_t(1) << 61) - 1;
+  Residue<modulus> minus_one(-1);
+  assert(minus_one.value() == modulus - 1);
+  std::ostringstream out;
+  out << minus_one << ' ' << Residue<modulus>(12345);
+  assert(out.str() == "2305843009213693950 12345");
+
+  assert(static_cast<int>(Residue<modulus>(12345)) == 12345);
+  bool thrown = false;
+  try {
+    static_cast<void>(static_cast<int>(minus_one));
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  assert(thrown);
+}
+
+int main() {
+  testPrimes();
+  testStrongPseudoprimes();
+  testArithmetic();
+  testBatchInvert();
+  testLargeModulus();
+  std::puts("ok");
+}
@@ -0,0 +1,63 @@
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+
+#include "../matrix.h"
+#include "rejects.h"
+
+// SparseMatrix elimination against the dense kernels.
+//   g++ -std=c++23 -O2 matrix_sparse.cpp
+
+template<typename Field>
+void compareWithDense(size_t rows, size_t columns, size_t density,
+                      std::mt19937& rng) {
+  DynMatrix<Field> dense(rows, columns);
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < columns; ++j) {
+      if (rng() % 100 < density) {
+        dense[i, j] = Field(static_cast<int>(rng() % 9) - 4);
+      }
+    }
+  }
+  SparseMatrix<Field> sparse(dense);
+  assert(sparse.rank() == dense.rank());
+  if (rows == columns) {
+    assert(sparse.det() == dense.det());
+  }
+}
+
+void testAgainstDense() {
+  std::mt19937 rng(3);
+  for (size_t trial = 0; trial < 300; ++trial) {
+    size_t rows = rng() % 12 + 1;
+    size_t columns = trial % 2 == 0 ? rows : rng() % 12 + 1;
+    size_t density = rng() % 100;
+    compareWithDense<Rational>(rows, columns, density, rng);
+    compareWithDense<Residue<7>>(rows, columns, density, rng);
+  }
+}
+
+void testShapes() {
+  CooMatrix<Rational> coo(2, 3);
+  coo.insert(0, 0, 1);
+  coo.insert(1, 1, 1);
+  assert(rejects<std::out_of_range>([&] { coo.insert(2, 0, 1); }));
+  assert(rejects<std::out_of_range>([&] { coo.insert(0, 3, 1); }));
+  SparseMatrix<Rational> wide(coo);
+  assert(wide.rank() == 2);
+  assert(rejects<std::invalid_argument>([&] { return wide.det(); },
+                                        "square matrix, got 2x3"));
+
+  DynMatrix<Rational> tall(3, 4);
+  assert((wide * tall).rows() == 2 && (wide * tall).columns() == 4);
+  DynMatrix<Rational> square(2, 2);
+  assert(rejects<std::invalid_argument>([&] { return wide * square; },
+                                        "2x3 SparseMatrix by a 2x2"));
+}
+
+int main() {
+  testAgainstDense();
+  testShapes();
+  std::puts("ok");
+}
@@ -0,0 +1,138 @@
+#include <cassert>
+#include <compare>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "../biginteger.h"
+
+// A Rational with a reduction threshold must be indistinguishable from an
+// eagerly reduced one through ==, <=>, toString() and double, whatever the
+// mix of lazy and eager operands, and setReductionThreshold(0) must bring
+// back the reduced representation exactly.
+//   g++ -std=c++20 -O2 rational_lazy.cpp
+//   g++ -std=c++20 -O2 -DBIGINTEGER_BINARY_LIMBS rational_lazy.cpp
+
+Rational randomRational(std::mt19937& rng) {
+  int32_t numerator = static_cast<int32_t>(rng() % 2001) - 1000;
+  int32_t denominator = static_cast<int32_t>(rng() % 60) + 1;
+  if (numerator == 0) {
+    numerator = 7;
+  }
+  return Rational(numerator, rng() % 2 == 0 ? denominator : -denominator);
+}
+
+void expectSame(const Rational& lazy, const Rational& eager) {
+  assert(lazy == eager && eager == lazy);
+  assert((lazy <=> eager) == std::strong_ordering::equal);
+  assert(lazy.toString() == eager.toString());
+  assert(lazy.asDecimal(20) == eager.asDecimal(20));
+  assert(static_cast<double>(lazy) == static_cast<double>(eager));
+  assert(lazy.getDenominator() > 0);
+}
+
+void expectOrdered(const Rational& lazy, const Rational& eager,
+                   const Rational& lazy_other, const Rational& eager_other) {
+  std::strong_ordering expected = eager <=> eager_other;
+  assert((lazy <=> lazy_other) == expected);
+  assert((lazy <=> eager_other) == expected);
+  assert((eager <=> lazy_other) == expected);
+  assert((lazy == lazy_other) == (eager == eager_other));
+  assert((lazy == eager_other) == (eager == eager_other));
+}
+
+void apply(Rational& value, const Rational& operand, size_t operation) {
+  switch (operation) {
+    case 0:
+      value += operand;
+      break;
+    case 1:
+      value -= operand;
+      break;
+    case 2:
+      value *= operand;
+      break;
+    default:
+      value /= operand;
+      break;
+  }
+}
+
+// Chains of all four operations. Each step takes its operand lazy or eager
+// at random, so lazy += eager, eager *= lazy and so on all occur.
+void testChains(size_t threshold, unsigned seed) {
+  std::mt19937 rng(seed);
+  size_t unreduced = 0;
+  for (size_t chain = 0; chain < 40; ++chain) {
+    Rational eager = randomRational(rng);
+    Rational lazy = eager;
+    lazy.setReductionThreshold(threshold);
+    Rational eager_into = randomRational(rng);
+    Rational lazy_into = eager_into;
+    for (size_t step = 0; step < 40; ++step) {
+      Rational eager_operand = randomRational(rng);
+      Rational lazy_operand = eager_operand;
+      lazy_operand.setReductionThreshold(threshold);
+      size_t operation = rng() % 4;
+
+      apply(eager, eager_operand, operation);
+      apply(lazy, rng() % 2 == 0 ? lazy_operand : eager_operand, operation);
+      expectSame(lazy, eager);
+
+      // An eager left-hand side picks up the threshold from a lazy operand.
+      apply(eager_into, eager, operation % 3);
+      apply(lazy_into, lazy, operation % 3);
+      expectSame(lazy_into, eager_into);
+      assert(lazy_into.reductionThreshold() == threshold);
+
+      expectSame(lazy + eager_operand, eager + eager_operand);
+      expectSame(eager_operand * lazy, eager_operand * eager);
+      expectOrdered(lazy, eager, lazy_operand, eager_operand);
+      expectOrdered(lazy, eager, lazy_into, eager_into);
+      unreduced += lazy.getDenominator() != eager.getDenominator();
+    }
+
+    lazy.setReductionThreshold(0);
+    assert(lazy.reductionThreshold() == 0);
+    assert(lazy.getNumerator() == eager.getNumerator());
+    assert(lazy.getDenominator() == eager.getDenominator());
+    expectSame(lazy, eager);
+    apply(lazy, Rational(3, 7), chain % 4);
+    apply(eager, Rational(3, 7), chain % 4);
+    assert(lazy.getNumerator() == eager.getNumerator());
+    assert(lazy.getDenominator() == eager.getDenominator());
+  }
+  // A threshold this high must actually leave values unreduced, or the test
+  // above checks nothing.
+  assert(threshold < 4 || unreduced > 0);
+}
+
+// Equal values with different representations: 2/4 built lazily against 1/2.
+void testUnreducedEquality() {
+  Rational half(1, 2);
+  Rational lazy(1, 4);
+  lazy.setReductionThreshold(32);
+  lazy += Rational(1, 4);
+  assert(lazy.getDenominator() == 4);
+  expectSame(lazy, half);
+  assert(lazy.toString() == "1/2");
+
+  Rational zero = lazy - half;
+  expectSame(zero, Rational(0));
+  assert(zero.toString() == "0");
+  Rational negative = zero - lazy;
+  expectSame(negative, Rational(-1, 2));
+  assert((negative <=> zero) == std::strong_ordering::less);
+
+  lazy.setReductionThreshold(0);
+  assert(lazy.getNumerator() == 1 && lazy.getDenominator() == 2);
+}
+
+int main() {
+  testUnreducedEquality();
+  testChains(1, 1);
+  testChains(4, 2);
+  testChains(32, 3);
+  testChains(1000, 4);
+  std::puts("ok");
+}
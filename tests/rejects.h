@@ -0,0 +1,19 @@
+#ifndef CPP_TESTS_REJECTS_H
+#define CPP_TESTS_REJECTS_H
+
+#include <string_view>
+
+// Whether operation() throws an Exception whose what() contains message.
+// Other exceptions propagate and fail the test.
+template<typename Exception, typename Operation>
+bool rejects(Operation operation, std::string_view message = "") {
+  try {
+    operation();
+  } catch (const Exception& error) {
+    return std::string_view(error.what()).find(message) !=
+           std::string_view::npos;
+  }
+  return false;
+}
+
+#endif //CPP_TESTS_REJECTS_H
@@ -0,0 +1,279 @@
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "../unordered_map.h"
+
+// UnorderedMap and FlatUnorderedMap against std::unordered_map under random
+// operations, including copies and moves taken right after a resize.
+//   g++ -std=c++20 -O2 unordered_map.cpp
+
+using Reference = std::unordered_map<std::string, std::string>;
+
+struct CollidingHash {
+  size_t operator()(const std::string& key) const { return std::hash<std::string>{}(key) % 7; }
+};
+
+template<typename Map>
+void expectEqual(const Map& map, const Reference& reference) {
+  assert(map.size() == reference.size());
+  size_t count = 0;
+  for (const auto& [key, value] : map) {
+    auto found = reference.find(key);
+    assert(found != reference.end() && found->second == value);
+    ++count;
+  }
+  assert(count == reference.size());
+  for (const auto& [key, value] : reference) {
+    auto found = map.find(key);
+    assert(found != map.end() && found->second == value);
+  }
+}
+
+template<typename Map>
+void compareWithStd(Map map, unsigned seed) {
+  std::mt19937 rng(seed);
+  Reference reference;
+  for (size_t step = 0; step < 30000; ++step) {
+    std::string key = "key" + std::to_string(rng() % 700);
+    std::string value(rng() % 32, static_cast<char>('a' + step % 26));
+    size_t buckets = map.bucket_count();
+    switch (rng() % 8) {
+      case 0: {
+        auto [iter, inserted] = map.insert({key, value});
+        auto [expected, expected_inserted] = reference.insert({key, value});
+        assert(inserted == expected_inserted && iter->second == expected->second);
+        break;
+      }
+      case 1: {
+        auto [iter, inserted] = map.emplace(key, value);
+        auto [expected, expected_inserted] = reference.emplace(key, value);
+        assert(inserted == expected_inserted && iter->second == expected->second);
+        break;
+      }
+      case 2:
+        map[key] += value;
+        reference[key] += value;
+        break;
+      case 3: {
+        auto iter = map.find(key);
+        auto expected = reference.find(key);
+        assert((iter == map.end()) == (expected == reference.end()));
+        if (iter != map.end()) {
+          map.erase(iter);
+          reference.erase(expected);
+        }
+        break;
+      }
+      case 4:
+        try {
+          assert(map.at(key) == reference.at(key));
+        } catch (const std::out_of_range&) {
+          assert(reference.count(key) == 0);
+        }
+        break;
+      case 5: {
+        Map copy(map);
+        map = Map();
+        map = copy;
+        break;
+      }
+      case 6: {
+        Map moved(std::move(map));
+        map = std::move(moved);
+        break;
+      }
+      default:
+        if (rng() % 200 == 0) {
+          map.clear();
+          reference.clear();
+        }
+        break;
+    }
+    assert(map.size() == reference.size());
+    if (map.bucket_count() != buckets) {
+      Map copy(map);
+      expectEqual(copy, reference);
+      Map moved(std::move(copy));
+      map = std::move(moved);
+      expectEqual(map, reference);
+    }
+  }
+  expectEqual(map, reference);
+
+  size_t buckets = map.bucket_count();
+  map.clear();
+  reference.clear();
+  assert(map.bucket_count() == buckets && map.begin() == map.end());
+  expectEqual(map, reference);
+  map["again"] = "value";
+  reference["again"] = "value";
+  expectEqual(map, reference);
+  map.erase(map.begin(), map.end());
+  assert(map.size() == 0);
+}
+
+struct ThrowingKey {
+  static inline bool throw_on_copy = false;
+
+  int value;
+
+  ThrowingKey(int value) : value(value) {}
+
+  ThrowingKey(const ThrowingKey& other) : value(other.value) {
+    if (throw_on_copy) {
+      throw std::runtime_error("key copy");
+    }
+  }
+
+  bool operator==(const ThrowingKey& other) const { return value == other.value; }
+};
+
+struct ThrowingKeyHash {
+  size_t operator()(const ThrowingKey& key) const { return std::hash<int>{}(key.value); }
+};
+
+// A key copy that throws while the table grows must leave every element in place.
+void testThrowingRehash() {
+  FlatUnorderedMap<ThrowingKey, int, ThrowingKeyHash> map;
+  for (int i = 0; i < 14; ++i) {
+    map[ThrowingKey(i)] = i;
+  }
+  size_t buckets = map.bucket_count();
+  ThrowingKey extra(14);
+  ThrowingKey::throw_on_copy = true;
+  bool thrown = false;
+  try {
+    map[extra] = 14;
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  ThrowingKey::throw_on_copy = false;
+  assert(thrown && map.size() == 14 && map.bucket_count() == buckets);
+  for (int i = 0; i < 14; ++i) {
+    assert(map.at(ThrowingKey(i)) == i);
+  }
+  map[extra] = 14;
+  assert(map.size() == 15 && map.at(extra) == 14);
+}
+
+struct ThrowingHash {
+  // The call that throws, counted down from when the test arms it; 0 disarms.
+  static inline int throw_after = 0;
+
+  size_t operator()(const std::string& key) const {
+    if (throw_after != 0 && --throw_after == 0) {
+      throw std::runtime_error("hash");
+    }
+    return std::hash<std::string>{}(key);
+  }
+};
+
+// A hash that throws partway through a rehash must not move any string key out of its slot.
+void testThrowingHashRehash() {
+  for (int call = 2; call <= 15; ++call) {
+    FlatUnorderedMap<std::string, int, ThrowingHash> map;
+    for (int i = 0; i < 14; ++i) {
+      map[std::to_string(i)] = i;
+    }
+    size_t buckets = map.bucket_count();
+    ThrowingHash::throw_after = call;
+    bool thrown = false;
+    try {
+      map["14"] = 14;
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    ThrowingHash::throw_after = 0;
+    assert(thrown && map.size() == 14 && map.bucket_count() == buckets);
+    for (int i = 0; i < 14; ++i) {
+      assert(map.at(std::to_string(i)) == i);
+    }
+  }
+}
+
+// An incremental resize must spread its work over inserts: no insert may initialize or
+// migrate more than a few dozen buckets, even after the max load factor drops mid-resize.
+void testIncrementalRehashBound() {
+  UnorderedMap<std::string, std::string> map;
+  map.set_incremental_rehash(true);
+  Reference reference;
+  size_t resizes = 0;
+  for (int i = 0; i < 200000; ++i) {
+    if (i == 100000) {
+      map.set_max_load_factor(0.1);
+    }
+    size_t pending = map.pending_rehash();
+    size_t buckets = map.bucket_count();
+    std::string key = std::to_string(i);
+    map[key] = key;
+    reference[key] = key;
+    assert(map.pending_rehash() <= pending || map.bucket_count() != buckets);
+    assert(map.pending_rehash() >= pending || pending - map.pending_rehash() <= 64);
+    if (map.bucket_count() != buckets) {
+      assert(pending <= 64);
+      ++resizes;
+    }
+  }
+  assert(resizes > 10 && map.size() == reference.size());
+  for (const auto& [key, value] : reference) {
+    assert(map.at(key) == value);
+  }
+}
+
+// Moving a map that is mid-resize hands the resize over as it is: the target finishes it
+// bucket by bucket on later inserts instead of rehashing everything in the assignment.
+void testMoveAssignMidResize() {
+  UnorderedMap<std::string, std::string> map;
+  map.set_incremental_rehash(true);
+  Reference reference;
+  for (int i = 0; map.pending_rehash() <= 64 || reference.size() < 1000; ++i) {
+    std::string key = std::to_string(i);
+    map[key] = key;
+    reference[key] = key;
+  }
+  size_t pending = map.pending_rehash();
+  size_t buckets = map.bucket_count();
+  UnorderedMap<std::string, std::string> target;
+  target["stale"] = "stale";
+  target = std::move(map);
+  assert(target.pending_rehash() == pending && target.bucket_count() == buckets);
+  expectEqual(target, reference);
+  for (int i = 0; target.pending_rehash() != 0; ++i) {
+    std::string key = "more" + std::to_string(i);
+    target[key] = key;
+    reference[key] = key;
+  }
+  expectEqual(target, reference);
+}
+
+template<typename Map>
+Map incremental() {
+  Map map;
+  map.set_incremental_rehash(true);
+  return map;
+}
+
+int main() {
+  using Modulo = UnorderedMap<std::string, std::string>;
+  using PowerOfTwo = UnorderedMap<std::string, std::string, std::hash<std::string>,
+          std::equal_to<std::string>, std::allocator<std::pair<const std::string, std::string>>,
+          PowerOfTwoBucketPolicy>;
+  using Colliding = UnorderedMap<std::string, std::string, CollidingHash>;
+
+  compareWithStd(Modulo(), 1);
+  compareWithStd(incremental<Modulo>(), 2);
+  compareWithStd(PowerOfTwo(), 3);
+  compareWithStd(incremental<PowerOfTwo>(), 4);
+  compareWithStd(incremental<Colliding>(), 5);
+  compareWithStd(FlatUnorderedMap<std::string, std::string>(), 6);
+  compareWithStd(FlatUnorderedMap<std::string, std::string, CollidingHash>(), 7);
+  testThrowingRehash();
+  testThrowingHashRehash();
+  testIncrementalRehashBound();
+  testMoveAssignMidResize();
+  std::puts("ok");
+}
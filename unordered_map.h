@@ -1,12 +1,70 @@
 #ifndef CPP_UNORDERED_MAP_H
 #define CPP_UNORDERED_MAP_H
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <bit>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <new>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+struct ModuloBucketPolicy {
+  static size_t index(size_t hash, size_t count) { return hash % count; }
+
+  static size_t round(size_t count) { return std::max<size_t>(count, 1); }
+
+  static size_t grow(size_t count) { return count * 2 + 1; }
+};
+
+struct PowerOfTwoBucketPolicy {
+  static size_t index(size_t hash, size_t count) { return mix(hash) & (count - 1); }
+
+  static size_t round(size_t count) { return std::bit_ceil(std::max<size_t>(count, 1)); }
+
+  static size_t grow(size_t count) { return count * 2; }
+
+  static size_t mix(size_t hash) {
+    uint64_t value = hash;
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    return value;
+  }
+};
+
+// std::allocator whose argument-less construct() default-initializes, so resize() on a
+// vector of bucket pointers leaves the new pointers uninitialized instead of zeroing them.
+template<typename T>
+struct DefaultInitAllocator : std::allocator<T> {
+  template<typename U>
+  struct rebind {
+    using other = DefaultInitAllocator<U>;
+  };
+
+  DefaultInitAllocator() = default;
+
+  template<typename U>
+  DefaultInitAllocator(const DefaultInitAllocator<U>&) noexcept {}
+
+  template<typename U, typename ...Args>
+  void construct(U* pointer, Args&& ... args) {
+    if constexpr (sizeof...(Args) == 0) {
+      ::new(static_cast<void*>(pointer)) U;
+    } else {
+      ::new(static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+    }
+  }
+};
 
 template<typename Key, typename Value, typename Hash=std::hash<Key>, typename Equal=std::equal_to<Key>,
-        typename Allocator=std::allocator<std::pair<const Key, Value>>>
+        typename Allocator=std::allocator<std::pair<const Key, Value>>,
+        typename BucketPolicy=ModuloBucketPolicy>
 class UnorderedMap {
 public:
   using NodeType = std::pair<Key, Value>;
@@ -15,19 +73,47 @@ public:
 private:
   class List;
 
+  using BucketVector = std::vector<typename List::Node*, DefaultInitAllocator<typename List::Node*>>;
+
+  static constexpr size_t rehash_step = 4;
+  static constexpr size_t initialize_step = 8 * rehash_step;
+
   List list;
-  std::vector<typename List::Node*> buckets;
+  BucketVector buckets;
+  BucketVector old_buckets;
+  size_t migrated;
+  size_t initialized;
 
   Allocator alloc;
 
   double current_load_factor;
   double mx_load_factor;
+  bool incremental;
 
   template<bool is_const>
   class common_iterator;
 
   void update_load_factor();
 
+  void assign_buckets(size_t count, bool resizing);
+
+  typename List::Node* find_in(const BucketVector& table, const Key& key,
+                               size_t hash) const;
+
+  typename List::Node* find_node(const Key& key, size_t hash) const;
+
+  bool in_old_table(const typename List::Node* node) const;
+
+  void place(typename List::Node* node, BucketVector& table);
+
+  void initialize_buckets(size_t count);
+
+  void migrate(size_t index);
+
+  void migrate_buckets(size_t count);
+
+  common_iterator<false> link(typename List::Node* node);
+
 public:
   using iterator = common_iterator<false>;
   using const_iterator = common_iterator<true>;
@@ -100,116 +186,142 @@ public:
 
   void set_max_load_factor(double factor);
 
+  bool incremental_rehash() const;
+
+  void set_incremental_rehash(bool enabled);
+
+  size_t pending_rehash() const;
+
   void rehash(size_t sz);
 
+  void clear();
+
   auto get_allocator() const;
 };
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-auto UnorderedMap<Key, Value, Hash, Equal, Allocator>::get_allocator() const {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+auto UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::get_allocator() const {
   return list.get_allocator();
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::UnorderedMap():buckets(
-        std::vector<typename List::Node*>(16)), current_load_factor(0), mx_load_factor(0.8) {}
-
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::UnorderedMap(const UnorderedMap& other) :
-        list(other.list), buckets(std::vector<typename List::Node*>(other.buckets.size())),
-        current_load_factor(other.current_load_factor), mx_load_factor(other.mx_load_factor) {
-  for (auto iter = list.begin(); iter != list.end(); ++iter) {
-    if (buckets[iter->hash % buckets.size()] == nullptr) {
-      buckets[iter->hash % buckets.size()] = &*iter;
-    }
-  }
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::UnorderedMap():buckets(
+        16, nullptr), migrated(0), initialized(16), current_load_factor(0),
+        mx_load_factor(0.8), incremental(false) {}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::UnorderedMap(const UnorderedMap& other) :
+        list(other.list), migrated(0), initialized(0), current_load_factor(other.current_load_factor),
+        mx_load_factor(other.mx_load_factor), incremental(other.incremental) {
+  assign_buckets(other.buckets.size(), !other.old_buckets.empty());
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::UnorderedMap(UnorderedMap&& other) noexcept :
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::UnorderedMap(
+        UnorderedMap&& other) noexcept :
         list(std::move(other.list), other.alloc), buckets(std::move(other.buckets)),
-        current_load_factor(other.current_load_factor), mx_load_factor(other.mx_load_factor) {
+        old_buckets(std::move(other.old_buckets)), migrated(other.migrated),
+        initialized(other.initialized), current_load_factor(other.current_load_factor), mx_load_factor(other.mx_load_factor),
+        incremental(other.incremental) {
+  other.migrated = 0;
+  other.initialized = 0;
   other.current_load_factor = 0;
   other.mx_load_factor = 0;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>&
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::operator=(const UnorderedMap& other) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>&
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::operator=(const UnorderedMap& other) {
   if (&other == this) {
     return *this;
   }
   list = other.list;
   current_load_factor = other.current_load_factor;
   mx_load_factor = other.mx_load_factor;
+  incremental = other.incremental;
 
-  buckets.assign(other.buckets.size(), nullptr);
-  for (auto iter = list.begin(); iter != list.end(); ++iter) {
-    if (buckets[iter->hash % buckets.size()] == nullptr) {
-      buckets[iter->hash % buckets.size()] = &*iter;
-    }
-  }
+  assign_buckets(other.buckets.size(), !other.old_buckets.empty());
   return *this;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>&
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::operator=(UnorderedMap&& other) noexcept {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>&
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::operator=(UnorderedMap&& other) noexcept {
   list = std::move(other.list);
   current_load_factor = other.current_load_factor;
   mx_load_factor = other.mx_load_factor;
+  incremental = other.incremental;
 
-  buckets.assign(other.buckets.size(), nullptr);
-  for (auto iter = list.begin(); iter != list.end(); ++iter) {
-    if (buckets[iter->hash % buckets.size()] == nullptr) {
-      buckets[iter->hash % buckets.size()] = &*iter;
-    }
+  if (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+    buckets = std::move(other.buckets);
+    old_buckets = std::move(other.old_buckets);
+    migrated = other.migrated;
+    initialized = other.initialized;
+  } else {
+    assign_buckets(other.buckets.size(), !other.old_buckets.empty());
   }
 
   other.buckets.clear();
+  other.old_buckets.clear();
+  other.migrated = 0;
+  other.initialized = 0;
   other.current_load_factor = 0;
   other.mx_load_factor = 0;
   return *this;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-Value& UnorderedMap<Key, Value, Hash, Equal, Allocator>::operator[](const Key& key) {
-  iterator iter = find(key);
-  if (iter == end()) {
-    size_t hash = Hash{}(key) % buckets.size();
-    if (buckets[hash] == nullptr) {
-      list.emplace(list.begin(), key, Value());
-      buckets[hash] = &*list.begin();
-    } else {
-      list.emplace(typename List::iterator(buckets[hash]), key, Value());
-      buckets[hash] = static_cast<List::Node*>(buckets[hash]->prev);
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::assign_buckets(
+        size_t count, bool resizing) {
+  buckets.assign(count, nullptr);
+  old_buckets.clear();
+  migrated = 0;
+  initialized = count;
+  if (resizing) {
+    rehash(count);
+    return;
+  }
+  for (auto iter = list.begin(); iter != list.end(); ++iter) {
+    if (buckets[BucketPolicy::index(iter->hash, buckets.size())] == nullptr) {
+      buckets[BucketPolicy::index(iter->hash, buckets.size())] = &*iter;
     }
-    update_load_factor();
-    iter = iterator(buckets[hash]);
   }
-  return iter->second;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-Value& UnorderedMap<Key, Value, Hash, Equal, Allocator>::operator[](Key&& key) {
-  iterator iter = find(key);
-  if (iter == end()) {
-    size_t hash = Hash{}(key) % buckets.size();
-    if (buckets[hash] == nullptr) {
-      list.emplace(list.begin(), std::move(key), Value());
-      buckets[hash] = &*list.begin();
-    } else {
-      list.emplace(typename List::iterator(buckets[hash]), std::move(key), Value());
-      buckets[hash] = static_cast<List::Node*>(buckets[hash]->prev);
-    }
-    update_load_factor();
-    iter = iterator(buckets[hash]);
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+Value& UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::operator[](const Key& key) {
+  size_t hash = Hash{}(key);
+  typename List::Node* node = find_node(key, hash);
+  if (node == nullptr) {
+    node = list.create(hash, key, Value());
+    link(node);
   }
-  return iter->second;
+  return node->pair.second;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-const Value& UnorderedMap<Key, Value, Hash, Equal, Allocator>::at(const Key& key) const {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+Value& UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::operator[](Key&& key) {
+  size_t hash = Hash{}(key);
+  typename List::Node* node = find_node(key, hash);
+  if (node == nullptr) {
+    node = list.create(hash, std::move(key), Value());
+    link(node);
+  }
+  return node->pair.second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+const Value& UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::at(const Key& key) const {
   const_iterator iter = find(key);
   if (iter == end()) {
     throw std::out_of_range("");
@@ -217,8 +329,9 @@ const Value& UnorderedMap<Key, Value, Hash, Equal, Allocator>::at(const Key& key
   return iter->second;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-Value& UnorderedMap<Key, Value, Hash, Equal, Allocator>::at(const Key& key) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+Value& UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::at(const Key& key) {
   iterator iter = find(key);
   if (iter == end()) {
     throw std::out_of_range("");
@@ -226,157 +339,130 @@ Value& UnorderedMap<Key, Value, Hash, Equal, Allocator>::at(const Key& key) {
   return iter->second;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-size_t UnorderedMap<Key, Value, Hash, Equal, Allocator>::size() const {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+size_t UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::size() const {
   return list.size();
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-size_t UnorderedMap<Key, Value, Hash, Equal, Allocator>::bucket_count() const {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+size_t UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::bucket_count() const {
   return buckets.size();
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator, bool>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::insert(const std::pair<Key, Value>& object) {
-  auto iter = find(object.first);
-  if (iter != end()) {
-    return {iter, false};
-  }
-  size_t hash = Hash{}(object.first) % buckets.size();
-  if (buckets[hash] == nullptr) {
-    list.emplace(list.begin(), object);
-    buckets[hash] = &*list.begin();
-  } else {
-    list.emplace(List::iterator(buckets[hash]), object);
-    buckets[hash] = static_cast<List::Node*>(buckets[hash]->prev);
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::insert(
+        const std::pair<Key, Value>& object) {
+  size_t hash = Hash{}(object.first);
+  typename List::Node* node = find_node(object.first, hash);
+  if (node != nullptr) {
+    return {iterator(node), false};
   }
-  update_load_factor();
-  return {iterator(buckets[hash]), true};
+  return {link(list.create(hash, object)), true};
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator, bool>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::insert(std::pair<Key, Value>&& object) {
-  auto iter = find(object.first);
-  if (iter != end()) {
-    return {iter, false};
-  }
-  size_t hash = Hash{}(object.first) % buckets.size();
-  if (buckets[hash] == nullptr) {
-    list.emplace(list.begin(), std::move(object));
-    buckets[hash] = &*list.begin();
-  } else {
-    list.emplace(typename List::iterator(buckets[hash]), std::move(object));
-    buckets[hash] = static_cast<List::Node*>(buckets[hash]->prev);
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::insert(std::pair<Key, Value>&& object) {
+  size_t hash = Hash{}(object.first);
+  typename List::Node* node = find_node(object.first, hash);
+  if (node != nullptr) {
+    return {iterator(node), false};
   }
-  update_load_factor();
-  return {iterator(buckets[hash]), true};
+  return {link(list.create(hash, std::move(object))), true};
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
 template<typename InputIterator>
 void
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::insert(InputIterator first, InputIterator last) {
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::insert(
+        InputIterator first, InputIterator last) {
   for (; first != last; ++first) {
     insert(*first);
   }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
 template<typename ...Args>
-std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator, bool>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::emplace(Args&& ... args) {
-  list.emplace(list.begin(), std::forward<Args>(args)...);
-  auto iter = find(list.begin()->pair.first);
-  if (iter != end()) {
-    list.pop_front();
-    return {iter, false};
-  }
-  size_t hash = list.begin()->hash % buckets.size();
-  if (buckets[hash] == nullptr) {
-    buckets[hash] = &*list.begin();
-  } else {
-    list.insert(typename List::iterator(buckets[hash]), list.extract(list.begin()));
-    buckets[hash] = static_cast<List::Node*>(buckets[hash]->prev);
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::emplace(Args&& ... args) {
+  typename List::Node* node = list.create(0, std::forward<Args>(args)...);
+  node->calculate_hash();
+  typename List::Node* other = find_node(node->pair.first, node->hash);
+  if (other != nullptr) {
+    list.destroy(node);
+    return {iterator(other), false};
   }
-  update_load_factor();
-  return {iterator(buckets[hash]), true};
+  return {link(node), true};
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator, bool>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::emplace(const ValueType& pair) {
-  auto iter = find(list.begin()->pair.first);
-  if (iter != end()) {
-    return {iter, false};
-  }
-  size_t hash = list.begin()->hash % buckets.size();
-  if (buckets[hash] == nullptr) {
-    list.emplace(list.begin(), pair);
-    buckets[hash] = &*list.begin();
-  } else {
-    list.emplace(typename List::iterator(buckets[hash]), pair);
-    buckets[hash] = static_cast<List::Node*>(buckets[hash]->prev);
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::emplace(const ValueType& pair) {
+  size_t hash = Hash{}(pair.first);
+  typename List::Node* node = find_node(pair.first, hash);
+  if (node != nullptr) {
+    return {iterator(node), false};
   }
-  update_load_factor();
-  return {iterator(buckets[hash]), true};
+  return {link(list.create(hash, pair)), true};
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator, bool>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::emplace(const Key& key, const Value& value) {
-  auto iter = find(key);
-  if (iter != end()) {
-    return {iter, false};
-  }
-  size_t hash = list.begin()->hash % buckets.size();
-  if (buckets[hash] == nullptr) {
-    list.emplace(list.begin(), key, value);
-    buckets[hash] = &*list.begin();
-  } else {
-    list.emplace(typename List::iterator(buckets[hash]), key, value);
-    buckets[hash] = static_cast<List::Node*>(buckets[hash]->prev);
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::emplace(
+        const Key& key, const Value& value) {
+  size_t hash = Hash{}(key);
+  typename List::Node* node = find_node(key, hash);
+  if (node != nullptr) {
+    return {iterator(node), false};
   }
-  update_load_factor();
-  return {iterator(buckets[hash]), true};
+  return {link(list.create(hash, key, value)), true};
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator, bool>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::emplace(const Key& key, Value&& value) {
-  auto iter = find(key);
-  if (iter != end()) {
-    return {iter, false};
-  }
-  size_t hash = list.begin()->hash % buckets.size();
-  if (buckets[hash] == nullptr) {
-    list.emplace(list.begin(), key, std::move(value));
-    buckets[hash] = &*list.begin();
-  } else {
-    list.emplace(typename List::iterator(buckets[hash]), key, std::move(value));
-    buckets[hash] = static_cast<List::Node*>(buckets[hash]->prev);
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::emplace(const Key& key, Value&& value) {
+  size_t hash = Hash{}(key);
+  typename List::Node* node = find_node(key, hash);
+  if (node != nullptr) {
+    return {iterator(node), false};
   }
-  update_load_factor();
-  return {iterator(buckets[hash]), true};
+  return {link(list.create(hash, key, std::move(value))), true};
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::erase(UnorderedMap::iterator iter) {
-  size_t hash = Hash{}(iter->first) % buckets.size();
-  typename List::Node* node = buckets[hash];
-  if (iterator(node) == iter) {
-    buckets[hash] = &*++typename List::iterator(buckets[hash]);
-    if (buckets[hash]->hash % buckets.size() != node->hash % buckets.size()) {
-      buckets[hash] = nullptr;
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::erase(UnorderedMap::iterator iter) {
+  typename List::Node* node = static_cast<typename List::Node*>(iter.list_iter.node);
+  bool old = in_old_table(node);
+  BucketVector& table = old ? old_buckets : buckets;
+  size_t index = BucketPolicy::index(node->hash, table.size());
+  if (table[index] == node) {
+    typename List::BaseNode* next = node->next;
+    if (next == &list.fake_node ||
+        BucketPolicy::index(static_cast<typename List::Node*>(next)->hash, table.size()) != index ||
+        in_old_table(static_cast<typename List::Node*>(next)) != old) {
+      table[index] = nullptr;
+    } else {
+      table[index] = static_cast<typename List::Node*>(next);
     }
   }
   list.erase(iter.list_iter);
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::erase(UnorderedMap::iterator first,
-                                                             UnorderedMap::iterator last) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::erase(
+        UnorderedMap::iterator first, UnorderedMap::iterator last) {
   auto prev_iter = first;
   while (first != last) {
     ++first;
@@ -385,92 +471,239 @@ void UnorderedMap<Key, Value, Hash, Equal, Allocator>::erase(UnorderedMap::itera
   }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::const_iterator
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::find(const Key& key) const {
-  size_t hash = Hash{}(key) % buckets.size();
-  if (buckets[hash] == nullptr) {
-    return end();
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::Node*
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::find_in(
+        const BucketVector& table, const Key& key, size_t hash) const {
+  size_t index = BucketPolicy::index(hash, table.size());
+  typename List::Node* node = table[index];
+  if (node == nullptr) {
+    return nullptr;
   }
-  auto iter = iterator(buckets[hash]);
-  while (!Equal{}(iter->first, key)) {
-    ++iter;
-    if (iter == end()) {
-      break;
+  while (true) {
+    if (node->hash == hash && Equal{}(node->pair.first, key)) {
+      return node;
+    }
+    if (node->next == &list.fake_node) {
+      return nullptr;
+    }
+    node = static_cast<typename List::Node*>(node->next);
+    if (BucketPolicy::index(node->hash, table.size()) != index) {
+      return nullptr;
     }
   }
-  return iter;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::find(const Key& key) {
-  size_t hash = Hash{}(key) % buckets.size();
-  if (buckets[hash] == nullptr) {
-    return end();
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::Node*
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::find_node(
+        const Key& key, size_t hash) const {
+  typename List::Node* node = initialized == buckets.size() ? find_in(buckets, key, hash) : nullptr;
+  if (node == nullptr && !old_buckets.empty()) {
+    node = find_in(old_buckets, key, hash);
+  }
+  return node;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+bool
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::in_old_table(
+        const typename List::Node* node) const {
+  return !old_buckets.empty() &&
+         old_buckets[BucketPolicy::index(node->hash, old_buckets.size())] != nullptr;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::place(
+        typename List::Node* node, BucketVector& table) {
+  size_t index = BucketPolicy::index(node->hash, table.size());
+  if (table[index] == nullptr) {
+    list.insert(list.begin(), node);
+  } else {
+    list.insert(typename List::iterator(table[index]), node);
   }
-  auto iter = iterator(buckets[hash]);
-  while (!Equal{}(iter->first, key)) {
-    ++iter;
-    if (iter == end()) {
+  table[index] = node;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::initialize_buckets(size_t count) {
+  size_t end = std::min(buckets.size(), initialized + count);
+  std::fill(buckets.begin() + initialized, buckets.begin() + end, nullptr);
+  initialized = end;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::migrate(size_t index) {
+  typename List::Node* node = old_buckets[index];
+  old_buckets[index] = nullptr;
+  while (node != nullptr) {
+    typename List::BaseNode* next = node->next;
+    place(list.extract(typename List::iterator(node)), buckets);
+    if (next == &list.fake_node ||
+        BucketPolicy::index(static_cast<typename List::Node*>(next)->hash,
+                            old_buckets.size()) != index) {
       break;
     }
+    node = static_cast<typename List::Node*>(next);
   }
-  return iter;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::reserve(size_t sz) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::migrate_buckets(size_t count) {
+  for (; count > 0 && !old_buckets.empty(); --count) {
+    migrate(migrated++);
+    if (migrated == old_buckets.size()) {
+      BucketVector().swap(old_buckets);
+      migrated = 0;
+    }
+  }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::iterator
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::link(typename List::Node* node) {
+  // The new table is nulled a chunk per insert before any node moves into it; until then
+  // new nodes go to the old table.
+  if (initialized < buckets.size()) {
+    initialize_buckets(initialize_step);
+    place(node, old_buckets);
+  } else {
+    if (!old_buckets.empty()) {
+      migrate(BucketPolicy::index(node->hash, old_buckets.size()));
+      migrate_buckets(rehash_step);
+    }
+    place(node, buckets);
+  }
+  update_load_factor();
+  return iterator(node);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::const_iterator
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::find(const Key& key) const {
+  typename List::Node* node = find_node(key, Hash{}(key));
+  return node == nullptr ? end() : const_iterator(node);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::iterator
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::find(const Key& key) {
+  typename List::Node* node = find_node(key, Hash{}(key));
+  return node == nullptr ? end() : iterator(node);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::reserve(size_t sz) {
   rehash(std::ceil(sz / max_load_factor()));
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-double UnorderedMap<Key, Value, Hash, Equal, Allocator>::max_load_factor() const {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+double UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::max_load_factor() const {
   return mx_load_factor;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-double UnorderedMap<Key, Value, Hash, Equal, Allocator>::load_factor() const {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+double UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::load_factor() const {
   return current_load_factor;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::set_max_load_factor(double factor) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::set_max_load_factor(double factor) {
   mx_load_factor = factor;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::rehash(size_t sz) {
-  sz = std::max(sz, static_cast<size_t>(std::ceil(size() / max_load_factor())));
-  List tmp_list(std::move(list));
-  buckets.clear();
-  buckets.resize(sz);
-  typename List::BaseNode* node = tmp_list.fake_node.next;
-  while (node != &tmp_list.fake_node) {
-    size_t hash = Hash{}(static_cast<typename List::Node*>(node)->pair.first) % buckets.size();
-    node = node->next;
-    if (buckets[hash] == nullptr) {
-      list.insert(list.begin(), tmp_list.extract(typename List::iterator(node->prev)));
-      buckets[hash] = &*list.begin();
-    } else {
-      list.insert(typename List::iterator(buckets[hash]),
-                  tmp_list.extract(typename List::iterator(node->prev)));
-    }
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+bool UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::incremental_rehash() const {
+  return incremental;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::set_incremental_rehash(bool enabled) {
+  incremental = enabled;
+  if (!incremental) {
+    initialize_buckets(buckets.size());
+    migrate_buckets(old_buckets.size());
+  }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+size_t UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::pending_rehash() const {
+  return buckets.size() - initialized + (old_buckets.empty() ? 0 : old_buckets.size() - migrated);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::rehash(size_t sz) {
+  sz = BucketPolicy::round(std::max(sz, static_cast<size_t>(std::ceil(size() / max_load_factor()))));
+  buckets.assign(sz, nullptr);
+  BucketVector().swap(old_buckets);
+  migrated = 0;
+  initialized = sz;
+  typename List::BaseNode* node = list.fake_node.next;
+  size_t count = list.size();
+  list.fake_node = typename List::BaseNode{&list.fake_node, &list.fake_node};
+  list.sz = 0;
+  for (size_t i = 0; i < count; ++i) {
+    typename List::BaseNode* next = node->next;
+    place(static_cast<typename List::Node*>(node), buckets);
+    node = next;
   }
   update_load_factor();
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::update_load_factor() {
-  current_load_factor = list.size() / buckets.size();
-  if (current_load_factor >= mx_load_factor) {
-    rehash(buckets.size() * 2 + 1);
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::clear() {
+  list.clear();
+  buckets.assign(buckets.size(), nullptr);
+  BucketVector().swap(old_buckets);
+  migrated = 0;
+  initialized = buckets.size();
+  current_load_factor = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::update_load_factor() {
+  current_load_factor = static_cast<double>(list.size()) / buckets.size();
+  if (current_load_factor < mx_load_factor) {
+    return;
+  }
+  if (!incremental) {
+    rehash(BucketPolicy::grow(buckets.size()));
+    return;
+  }
+  // A resize still in progress finishes in its bounded steps before the next one starts.
+  if (!old_buckets.empty()) {
+    return;
   }
+  old_buckets.swap(buckets);
+  buckets.resize(BucketPolicy::grow(old_buckets.size()));
+  initialized = 0;
+  current_load_factor = static_cast<double>(list.size()) / buckets.size();
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
 template<bool is_const>
-class UnorderedMap<Key, Value, Hash, Equal, Allocator>::common_iterator {
+class UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::common_iterator {
   friend UnorderedMap;
 
   using Type = std::conditional_t<is_const, const ValueType, ValueType>;
@@ -540,8 +773,9 @@ public:
   }
 };
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-class UnorderedMap<Key, Value, Hash, Equal, Allocator>::List {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+class UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List {
 public:
   struct BaseNode {
     BaseNode* next;
@@ -560,11 +794,84 @@ public:
   using NodeAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
   using NodeAllocatorTraits = typename std::allocator_traits<NodeAlloc>;
 
+  class Pool {
+    static constexpr size_t min_slab = 16;
+    static constexpr size_t max_slab = 4096;
+
+    struct SlabHeader {
+      Node* prev;
+      size_t count;
+    };
+
+    static_assert(sizeof(SlabHeader) <= sizeof(Node) && alignof(SlabHeader) <= alignof(Node));
+
+    Node* slabs = nullptr;
+    BaseNode* free_list = nullptr;
+    Node* cursor = nullptr;
+    Node* limit = nullptr;
+
+    static SlabHeader* header(Node* slab) {
+      return std::launder(reinterpret_cast<SlabHeader*>(slab));
+    }
+
+  public:
+    Pool() = default;
+
+    Pool(Pool&& other) noexcept : slabs(std::exchange(other.slabs, nullptr)),
+            free_list(std::exchange(other.free_list, nullptr)),
+            cursor(std::exchange(other.cursor, nullptr)), limit(std::exchange(other.limit, nullptr)) {}
+
+    Pool& operator=(Pool&& other) noexcept {
+      slabs = std::exchange(other.slabs, nullptr);
+      free_list = std::exchange(other.free_list, nullptr);
+      cursor = std::exchange(other.cursor, nullptr);
+      limit = std::exchange(other.limit, nullptr);
+      return *this;
+    }
+
+    Node* allocate(NodeAlloc& alloc) {
+      if (free_list != nullptr) {
+        Node* node = static_cast<Node*>(free_list);
+        free_list = free_list->next;
+        return node;
+      }
+      if (cursor == limit) {
+        size_t count = slabs == nullptr ? min_slab : std::min(header(slabs)->count * 2, max_slab);
+        Node* slab = NodeAllocatorTraits::allocate(alloc, count);
+        ::new(static_cast<void*>(slab)) SlabHeader{slabs, count};
+        slabs = slab;
+        cursor = slab + 1;
+        limit = slab + count;
+      }
+      return cursor++;
+    }
+
+    void deallocate(Node* node) {
+      node->next = free_list;
+      free_list = node;
+    }
+
+    void release(NodeAlloc& alloc) {
+      while (slabs != nullptr) {
+        Node* slab = slabs;
+        SlabHeader* slab_header = header(slab);
+        slabs = slab_header->prev;
+        size_t count = slab_header->count;
+        slab_header->~SlabHeader();
+        NodeAllocatorTraits::deallocate(alloc, slab, count);
+      }
+      free_list = nullptr;
+      cursor = nullptr;
+      limit = nullptr;
+    }
+  };
+
   BaseNode fake_node;
   size_t sz;
 
   [[no_unique_address]] Allocator allocator;
   [[no_unique_address]] NodeAlloc node_allocator;
+  Pool pool;
 
   explicit List(const Allocator& alloc = Allocator());
 
@@ -598,6 +905,8 @@ public:
 
   void pop_front();
 
+  void clear();
+
   template<bool is_const>
   class common_iterator;
 
@@ -638,6 +947,11 @@ public:
 
   void insert(iterator pos, List::Node* node);
 
+  template<typename ...Args>
+  List::Node* create(size_t hash, Args&& ... args);
+
+  void destroy(List::Node* node);
+
   template<typename ...Args>
   void emplace(iterator pos, Args&& ... args);
 
@@ -649,20 +963,22 @@ public:
   void erase(const_iterator pos);
 };
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(const Allocator& alloc) :
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::List(const Allocator& alloc) :
         fake_node(BaseNode{&fake_node, &fake_node}), sz(0), allocator(alloc),
         node_allocator(alloc) {}
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(size_t count, const ValueType& value,
-                                                             const Allocator& alloc) :
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::List(
+        size_t count, const ValueType& value, const Allocator& alloc) :
         fake_node(BaseNode{&fake_node, &fake_node}), sz(count), allocator(alloc),
         node_allocator(alloc) {
   BaseNode* prev_node = &fake_node;
   try {
     for (size_t i = 0; i < count; ++i) {
-      prev_node->next = NodeAllocatorTraits::allocate(node_allocator, 1);
+      prev_node->next = pool.allocate(node_allocator);
       NodeAllocatorTraits::template construct<NodeType>(node_allocator,
                                                         &static_cast<Node*>(prev_node->next)->pair,
                                                         value);
@@ -679,21 +995,22 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(size_t count, const
       prev_node = prev_node->prev;
       NodeAllocatorTraits::template destroy<NodeType>(node_allocator,
                                                       &static_cast<Node*>(prev_node->next)->pair);
-      NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(prev_node->next), 1);
     }
+    pool.release(node_allocator);
     throw;
   }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(size_t count, ValueType&& value,
-                                                             const Allocator& alloc) :
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::List(
+        size_t count, ValueType&& value, const Allocator& alloc) :
         fake_node(BaseNode{&fake_node, &fake_node}), sz(count), allocator(alloc),
         node_allocator(alloc) {
   BaseNode* prev_node = &fake_node;
   try {
     for (size_t i = 0; i < count; ++i) {
-      prev_node->next = NodeAllocatorTraits::allocate(node_allocator, 1);
+      prev_node->next = pool.allocate(node_allocator);
       NodeAllocatorTraits::template construct<NodeType>(node_allocator,
                                                         &static_cast<Node*>(prev_node->next)->pair,
                                                         std::move(value));
@@ -706,25 +1023,26 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(size_t count, Value
     prev_node->next = &fake_node;
     fake_node.prev = prev_node;
   } catch (...) {
-    NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(prev_node->next), 1);
     while (prev_node != &fake_node) {
       prev_node = prev_node->prev;
       NodeAllocatorTraits::template destroy<NodeType>(node_allocator,
                                                       &static_cast<Node*>(prev_node->next)->pair);
-      NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(prev_node->next), 1);
     }
+    pool.release(node_allocator);
     throw;
   }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(size_t count, const Allocator& alloc)
-        : fake_node(BaseNode{&fake_node, &fake_node}), sz(count), allocator(alloc),
-          node_allocator(alloc) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::List(
+        size_t count, const Allocator& alloc) :
+        fake_node(BaseNode{&fake_node, &fake_node}), sz(count), allocator(alloc),
+        node_allocator(alloc) {
   BaseNode* prev_node = &fake_node;
   try {
     for (size_t i = 0; i < count; ++i) {
-      prev_node->next = NodeAllocatorTraits::allocate(node_allocator, 1);
+      prev_node->next = pool.allocate(node_allocator);
       NodeAllocatorTraits::template construct<NodeType>(node_allocator,
                                                         &static_cast<Node*>(prev_node->next)->pair);
       static_cast<Node*>(prev_node->next)->calculate_hash();
@@ -736,19 +1054,19 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(size_t count, const
     prev_node->next = &fake_node;
     fake_node.prev = prev_node;
   } catch (...) {
-    NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(prev_node->next), 1);
     while (prev_node != &fake_node) {
       prev_node = prev_node->prev;
       NodeAllocatorTraits::template destroy<NodeType>(node_allocator,
                                                       &static_cast<Node*>(prev_node->next)->pair);
-      NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(prev_node->next), 1);
     }
+    pool.release(node_allocator);
     throw;
   }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(const List& other) : fake_node(
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::List(const List& other) : fake_node(
         BaseNode{&fake_node, &fake_node}), sz(other.sz), allocator(
         std::allocator_traits<Allocator>::select_on_container_copy_construction(
                 other.get_allocator())), node_allocator(allocator) {
@@ -756,11 +1074,11 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(const List& other)
   try {
     BaseNode* node = other.fake_node.next;
     for (size_t i = 0; i < other.sz; ++i) {
-      prev_node->next = NodeAllocatorTraits::allocate(node_allocator, 1);
+      prev_node->next = pool.allocate(node_allocator);
       NodeAllocatorTraits::template construct<NodeType>(node_allocator,
                                                         &static_cast<Node*>(prev_node->next)->pair,
                                                         static_cast<Node*>(node)->pair);
-      static_cast<Node*>(prev_node->next)->calculate_hash();
+      static_cast<Node*>(prev_node->next)->hash = static_cast<Node*>(node)->hash;
 
       prev_node->next->prev = prev_node;
       prev_node = prev_node->next;
@@ -770,21 +1088,22 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(const List& other)
     prev_node->next = &fake_node;
     fake_node.prev = prev_node;
   } catch (...) {
-    NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(prev_node->next), 1);
     while (prev_node != &fake_node) {
       prev_node = prev_node->prev;
       NodeAllocatorTraits::template destroy<NodeType>(node_allocator,
                                                       &static_cast<Node*>(prev_node->next)->pair);
-      NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(prev_node->next), 1);
     }
+    pool.release(node_allocator);
     throw;
   }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(List&& other) noexcept :
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::List(List&& other) noexcept :
         allocator(std::allocator_traits<Allocator>::select_on_container_copy_construction(
-                std::move(other.get_allocator()))), node_allocator(allocator) {
+                std::move(other.get_allocator()))), node_allocator(allocator),
+        pool(std::move(other.pool)) {
   fake_node = BaseNode{&fake_node, &fake_node};
   sz = other.sz;
   if (sz != 0) {
@@ -796,10 +1115,11 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(List&& other) noexc
   }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(List&& other,
-                                                             const Allocator& alloc) noexcept :
-        allocator(alloc), node_allocator(alloc) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::List(
+        List&& other, const Allocator& alloc) noexcept :
+        allocator(alloc), node_allocator(alloc), pool(std::move(other.pool)) {
   fake_node = BaseNode{&fake_node, &fake_node};
   sz = other.sz;
   if (sz != 0) {
@@ -811,10 +1131,11 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::List(List&& other,
   }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List&
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::operator=(
-        const UnorderedMap<Key, Value, Hash, Equal, Allocator>::List& other) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List&
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::operator=(
+        const UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List& other) {
   if (this == &other) {
     return *this;
   }
@@ -822,6 +1143,7 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::operator=(
   BaseNode tmp_fake_node = fake_node;
   Allocator tmp_allocator = allocator;
   NodeAlloc tmp_node_allocator = node_allocator;
+  Pool tmp_pool(std::move(pool));
 
   if (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value) {
     allocator = other.get_allocator();
@@ -832,11 +1154,11 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::operator=(
   try {
     BaseNode* node = other.fake_node.next;
     for (size_t i = 0; i < other.sz; ++i) {
-      prev_node->next = NodeAllocatorTraits::allocate(node_allocator, 1);
+      prev_node->next = pool.allocate(node_allocator);
       NodeAllocatorTraits::template construct<NodeType>(node_allocator,
                                                         &static_cast<Node*>(prev_node->next)->pair,
                                                         static_cast<Node*>(node)->pair);
-      static_cast<Node*>(prev_node->next)->calculate_hash();
+      static_cast<Node*>(prev_node->next)->hash = static_cast<Node*>(node)->hash;
 
       prev_node->next->prev = prev_node;
       prev_node = prev_node->next;
@@ -847,47 +1169,45 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::operator=(
     fake_node.prev = prev_node;
     sz = other.sz;
   } catch (...) {
-    NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(prev_node->next), 1);
     while (prev_node != &fake_node) {
       prev_node = prev_node->prev;
       NodeAllocatorTraits::template destroy<NodeType>(node_allocator,
                                                       &static_cast<Node*>(prev_node->next)->pair);
-      NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(prev_node->next), 1);
     }
+    pool.release(node_allocator);
 
     fake_node = tmp_fake_node;
     allocator = tmp_allocator;
     node_allocator = tmp_node_allocator;
+    pool = std::move(tmp_pool);
 
     throw;
   }
 
-  BaseNode* node = tmp_fake_node.next;
-  tmp_fake_node.prev->next = &tmp_fake_node;
-  while (node != &tmp_fake_node) {
-    NodeAllocatorTraits::template destroy<NodeType>(tmp_node_allocator,
-                                                    &static_cast<Node*>(node)->pair);
-    node = node->next;
-    NodeAllocatorTraits::deallocate(tmp_node_allocator, static_cast<Node*>(node->prev), 1);
+  if (tmp_fake_node.next != &fake_node) {
+    BaseNode* node = tmp_fake_node.next;
+    tmp_fake_node.prev->next = &tmp_fake_node;
+    while (node != &tmp_fake_node) {
+      NodeAllocatorTraits::template destroy<NodeType>(tmp_node_allocator,
+                                                      &static_cast<Node*>(node)->pair);
+      node = node->next;
+    }
   }
+  tmp_pool.release(tmp_node_allocator);
 
   return *this;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List&
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::operator=(
-        UnorderedMap<Key, Value, Hash, Equal, Allocator>::List&& other) noexcept {
-  BaseNode* node = fake_node.next;
-  while (node != &fake_node) {
-    NodeAllocatorTraits::template destroy<NodeType>(node_allocator,
-                                                    &static_cast<Node*>(node)->pair);
-    node = node->next;
-    NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(node->prev), 1);
-  }
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List&
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::operator=(
+        UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List&& other) noexcept {
+  clear();
   if (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
     allocator = other.get_allocator();
     node_allocator = allocator;
+    pool = std::move(other.pool);
     fake_node = BaseNode{&fake_node, &fake_node};
     sz = other.sz;
     if (sz != 0) {
@@ -906,12 +1226,12 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::operator=(
   BaseNode* prev_node = &fake_node;
   BaseNode* other_node = other.fake_node.next;
   for (size_t i = 0; i < other.sz; ++i) {
-    prev_node->next = NodeAllocatorTraits::allocate(node_allocator, 1);
+    prev_node->next = pool.allocate(node_allocator);
     NodeAllocatorTraits::template construct<NodeType>(node_allocator,
                                                       &static_cast<Node*>(prev_node->next)->pair,
                                                       std::forward<NodeType>(
                                                               static_cast<Node*>(other_node)->pair));
-    static_cast<Node*>(prev_node->next)->calculate_hash();
+    static_cast<Node*>(prev_node->next)->hash = static_cast<Node*>(other_node)->hash;
 
     prev_node->next->prev = prev_node;
     prev_node = prev_node->next;
@@ -919,7 +1239,6 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::operator=(
 
     NodeAllocatorTraits::template destroy<NodeType>(other_node_allocator,
                                                     &static_cast<Node*>(other_node->prev)->pair);
-    NodeAllocatorTraits::deallocate(other_node_allocator, static_cast<Node*>(other_node->prev), 1);
   }
 
   prev_node->next = &fake_node;
@@ -929,24 +1248,36 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::operator=(
   other.fake_node.next = &other.fake_node;
   other.fake_node.prev = &other.fake_node;
   other.sz = 0;
+  other.pool.release(other_node_allocator);
 
   return *this;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::~List() {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::~List() {
+  clear();
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::clear() {
   BaseNode* node = fake_node.next;
   while (node != &fake_node) {
     NodeAllocatorTraits::template destroy<NodeType>(node_allocator,
                                                     &static_cast<Node*>(node)->pair);
     node = node->next;
-    NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(node->prev), 1);
   }
+  fake_node = BaseNode{&fake_node, &fake_node};
+  sz = 0;
+  pool.release(node_allocator);
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::push_back(const ValueType& value) {
-  Node* node = NodeAllocatorTraits::allocate(node_allocator, 1);
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::push_back(
+        const ValueType& value) {
+  Node* node = pool.allocate(node_allocator);
   NodeAllocatorTraits::template construct<NodeType>(node_allocator, &node->pair, value);
   node->calculate_hash();
 
@@ -958,9 +1289,11 @@ void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::push_back(const Val
   ++sz;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::push_front(const ValueType& value) {
-  Node* node = NodeAllocatorTraits::allocate(node_allocator, 1);
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::push_front(
+        const ValueType& value) {
+  Node* node = pool.allocate(node_allocator);
   NodeAllocatorTraits::template construct<NodeType>(node_allocator, &node->pair, value);
   node->calculate_hash();
 
@@ -972,35 +1305,38 @@ void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::push_front(const Va
   ++sz;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::pop_back() {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::pop_back() {
   BaseNode* node = fake_node.prev;
   fake_node.prev = fake_node.prev->prev;
   fake_node.prev->next = &fake_node;
 
   NodeAllocatorTraits::template destroy<NodeType>(node_allocator, &static_cast<Node*>(node)->pair);
-  NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(node), 1);
+  pool.deallocate(static_cast<Node*>(node));
 
   --sz;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::pop_front() {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::pop_front() {
   BaseNode* node = fake_node.next;
   fake_node.next = fake_node.next->next;
   fake_node.next->prev = &fake_node;
 
   NodeAllocatorTraits::template destroy<NodeType>(node_allocator, &static_cast<Node*>(node)->pair);
-  NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(node), 1);
+  pool.deallocate(static_cast<Node*>(node));
 
   --sz;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::insert(
-        UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::iterator pos,
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::insert(
+        UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::iterator pos,
         const ValueType& value) {
-  Node* node = NodeAllocatorTraits::allocate(node_allocator, 1);
+  Node* node = pool.allocate(node_allocator);
   NodeAllocatorTraits::template construct<NodeType>(node_allocator, &node->pair, value);
   node->calculate_hash();
 
@@ -1012,16 +1348,18 @@ void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::insert(
   ++sz;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::insert(
-        UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::const_iterator pos,
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::insert(
+        UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::const_iterator pos,
         const ValueType& value) {
   insert(pos.iter_const_cast(), value);
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::Node*
-UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::extract(iterator pos) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::Node*
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::extract(iterator pos) {
   pos.node->prev->next = pos.node->next;
   pos.node->next->prev = pos.node->prev;
 
@@ -1030,9 +1368,10 @@ UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::extract(iterator pos) {
   return static_cast<Node*>(pos.node);
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::insert(iterator pos,
-                                                                    List::Node* node) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::insert(
+        iterator pos, List::Node* node) {
   pos.node->prev->next = node;
   node->next = pos.node;
   node->prev = pos.node->prev;
@@ -1041,11 +1380,38 @@ void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::insert(iterator pos
   ++sz;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+template<typename ...Args>
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::Node*
+UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::create(size_t hash, Args&& ...args) {
+  Node* node = pool.allocate(node_allocator);
+  try {
+    NodeAllocatorTraits::template construct(node_allocator,
+                                            reinterpret_cast<ValueType*>(&node->pair),
+                                            std::forward<Args>(args)...);
+  } catch (...) {
+    pool.deallocate(node);
+    throw;
+  }
+  node->hash = hash;
+  return node;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::destroy(List::Node* node) {
+  NodeAllocatorTraits::template destroy<NodeType>(node_allocator, &node->pair);
+  pool.deallocate(node);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
 template<typename ...Args>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::emplace(
-        UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::iterator pos, Args&& ...args) {
-  Node* node = NodeAllocatorTraits::allocate(node_allocator, 1);
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::emplace(
+        UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::iterator pos,
+        Args&& ...args) {
+  Node* node = pool.allocate(node_allocator);
   NodeAllocatorTraits::template construct(node_allocator, reinterpret_cast<ValueType*>(&node->pair),
                                           std::forward<Args>(args)...);
   node->calculate_hash();
@@ -1059,37 +1425,41 @@ void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::emplace(
 }
 
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
 template<typename ...Args>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::emplace(
-        UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::const_iterator pos,
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::emplace(
+        UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::const_iterator pos,
         Args&& ...args) {
   insert(pos.iter_const_cast(), std::forward<Args>(args)...);
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::erase(
-        UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::iterator pos) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::erase(
+        UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::iterator pos) {
   pos.node->prev->next = pos.node->next;
   pos.node->next->prev = pos.node->prev;
 
   NodeAllocatorTraits::template destroy<NodeType>(node_allocator,
                                                   &static_cast<Node*>(pos.node)->pair);
-  NodeAllocatorTraits::deallocate(node_allocator, static_cast<Node*>(pos.node), 1);
+  pool.deallocate(static_cast<Node*>(pos.node));
 
   --sz;
 }
 
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
-void UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::erase(
-        UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::const_iterator pos) {
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
+void UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::erase(
+        UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::const_iterator pos) {
   erase(pos.iter_const_cast());
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator,
+        typename BucketPolicy>
 template<bool is_const>
-class UnorderedMap<Key, Value, Hash, Equal, Allocator>::List::common_iterator {
+class UnorderedMap<Key, Value, Hash, Equal, Allocator, BucketPolicy>::List::common_iterator {
   friend List;
 public:
 
@@ -1158,4 +1528,670 @@ public:
   }
 };
 
+// Open-addressing counterpart of UnorderedMap with the same interface. Elements live inline in
+// the slot array, so unlike UnorderedMap a rehash moves them. An insert, emplace or operator[]
+// that rehashes (to grow or to drop tombstones), and every reserve or rehash call, invalidates
+// all iterators, pointers and references into the map. Erase invalidates only the erased
+// element.
+template<typename Key, typename Value, typename Hash=std::hash<Key>, typename Equal=std::equal_to<Key>,
+        typename Allocator=std::allocator<std::pair<const Key, Value>>>
+class FlatUnorderedMap {
+public:
+  using NodeType = std::pair<Key, Value>;
+  using ValueType = std::pair<const Key, Value>;
+
+private:
+  using SlotAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<NodeType>;
+  using SlotAllocatorTraits = std::allocator_traits<SlotAlloc>;
+  using ControlAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<int8_t>;
+  using ControlAllocatorTraits = std::allocator_traits<ControlAlloc>;
+
+  static constexpr size_t group_width = 16;
+  static constexpr int8_t empty_control = -128;
+  static constexpr int8_t deleted_control = -2;
+  static constexpr int8_t sentinel_control = -1;
+  static constexpr double max_possible_load_factor = 0.875;
+
+  [[no_unique_address]] Allocator alloc;
+  [[no_unique_address]] SlotAlloc slot_allocator;
+  [[no_unique_address]] ControlAlloc control_allocator;
+
+  int8_t* control;
+  NodeType* slots;
+  size_t capacity;
+  size_t sz;
+  size_t deleted;
+
+  double mx_load_factor;
+
+  template<bool is_const>
+  class common_iterator;
+
+  static size_t mix_hash(size_t hash);
+
+  static uint32_t match(const int8_t* group, int8_t value);
+
+  static uint32_t match_free(const int8_t* group);
+
+  size_t find_index(const Key& key, size_t hash) const;
+
+  static size_t find_free(const int8_t* control, size_t capacity, size_t hash);
+
+  template<typename ...Args>
+  size_t emplace_new(size_t hash, Args&& ... args);
+
+  void allocate_arrays(size_t count, int8_t*& new_control, NodeType*& new_slots);
+
+  void allocate(size_t count);
+
+  void release();
+
+public:
+  using iterator = common_iterator<false>;
+  using const_iterator = common_iterator<true>;
+
+  FlatUnorderedMap();
+
+  FlatUnorderedMap(const FlatUnorderedMap& other);
+
+  FlatUnorderedMap(FlatUnorderedMap&& other) noexcept;
+
+  FlatUnorderedMap& operator=(const FlatUnorderedMap& other);
+
+  FlatUnorderedMap& operator=(FlatUnorderedMap&& other) noexcept;
+
+  ~FlatUnorderedMap();
+
+  Value& operator[](const Key& key);
+
+  Value& operator[](Key&& key);
+
+  Value& at(const Key& key);
+
+  const Value& at(const Key& key) const;
+
+  size_t size() const;
+
+  size_t bucket_count() const;
+
+  iterator begin();
+
+  iterator end() { return iterator(control + capacity, slots + capacity); }
+
+  const_iterator begin() const;
+
+  const_iterator end() const { return const_iterator(control + capacity, slots + capacity); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  std::pair<iterator, bool> insert(const NodeType& object);
+
+  std::pair<iterator, bool> insert(NodeType&& object);
+
+  template<typename InputIterator>
+  void insert(InputIterator first, InputIterator last);
+
+  template<typename ...Args>
+  std::pair<iterator, bool> emplace(Args&& ... args);
+
+  void erase(iterator iter);
+
+  void erase(iterator first, iterator last);
+
+  void clear();
+
+  iterator find(const Key& key);
+
+  const_iterator find(const Key& key) const;
+
+  void reserve(size_t count);
+
+  double load_factor() const;
+
+  double max_load_factor() const;
+
+  void set_max_load_factor(double factor);
+
+  void rehash(size_t count);
+
+  auto get_allocator() const;
+};
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::FlatUnorderedMap() :
+        slot_allocator(alloc), control_allocator(alloc), control(nullptr), slots(nullptr),
+        capacity(0), sz(0), deleted(0), mx_load_factor(max_possible_load_factor) {}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::FlatUnorderedMap(const FlatUnorderedMap& other) :
+        alloc(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc)),
+        slot_allocator(alloc), control_allocator(alloc), control(nullptr), slots(nullptr),
+        capacity(0), sz(0), deleted(0), mx_load_factor(other.mx_load_factor) {
+  if (other.capacity == 0) {
+    return;
+  }
+  allocate(other.capacity);
+  size_t index = 0;
+  try {
+    for (; index < capacity; ++index) {
+      if (other.control[index] >= 0) {
+        SlotAllocatorTraits::construct(slot_allocator, slots + index, other.slots[index]);
+      }
+    }
+  } catch (...) {
+    while (index-- > 0) {
+      if (other.control[index] >= 0) {
+        SlotAllocatorTraits::destroy(slot_allocator, slots + index);
+      }
+    }
+    release();
+    throw;
+  }
+  std::copy(other.control, other.control + capacity, control);
+  sz = other.sz;
+  deleted = other.deleted;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::FlatUnorderedMap(FlatUnorderedMap&& other) noexcept :
+        alloc(std::move(other.alloc)), slot_allocator(alloc), control_allocator(alloc),
+        control(other.control), slots(other.slots), capacity(other.capacity), sz(other.sz),
+        deleted(other.deleted), mx_load_factor(other.mx_load_factor) {
+  other.control = nullptr;
+  other.slots = nullptr;
+  other.capacity = 0;
+  other.sz = 0;
+  other.deleted = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>&
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::operator=(const FlatUnorderedMap& other) {
+  if (&other == this) {
+    return *this;
+  }
+  FlatUnorderedMap tmp(other);
+  *this = std::move(tmp);
+  return *this;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>&
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::operator=(FlatUnorderedMap&& other) noexcept {
+  if (&other == this) {
+    return *this;
+  }
+  release();
+  alloc = std::move(other.alloc);
+  slot_allocator = alloc;
+  control_allocator = alloc;
+  control = other.control;
+  slots = other.slots;
+  capacity = other.capacity;
+  sz = other.sz;
+  deleted = other.deleted;
+  mx_load_factor = other.mx_load_factor;
+
+  other.control = nullptr;
+  other.slots = nullptr;
+  other.capacity = 0;
+  other.sz = 0;
+  other.deleted = 0;
+  return *this;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::~FlatUnorderedMap() {
+  release();
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+auto FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::get_allocator() const {
+  return alloc;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+size_t FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::mix_hash(size_t hash) {
+  return PowerOfTwoBucketPolicy::mix(hash);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+uint32_t FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::match(const int8_t* group, int8_t value) {
+#if defined(__SSE2__)
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value)));
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < group_width; ++i) {
+    mask |= static_cast<uint32_t>(group[i] == value) << i;
+  }
+  return mask;
+#endif
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+uint32_t FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::match_free(const int8_t* group) {
+#if defined(__SSE2__)
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+  return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(sentinel_control), bytes));
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < group_width; ++i) {
+    mask |= static_cast<uint32_t>(group[i] < sentinel_control) << i;
+  }
+  return mask;
+#endif
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+size_t FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::find_index(const Key& key,
+                                                                       size_t hash) const {
+  if (capacity == 0) {
+    return capacity;
+  }
+  size_t group_mask = capacity / group_width - 1;
+  size_t group = (hash >> 7) & group_mask;
+  int8_t tag = static_cast<int8_t>(hash & 0x7F);
+  for (size_t step = 1;; ++step) {
+    const int8_t* base = control + group * group_width;
+    for (uint32_t mask = match(base, tag); mask != 0; mask &= mask - 1) {
+      size_t index = group * group_width + std::countr_zero(mask);
+      if (Equal{}(slots[index].first, key)) {
+        return index;
+      }
+    }
+    if (match(base, empty_control) != 0) {
+      return capacity;
+    }
+    group = (group + step) & group_mask;
+  }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+size_t FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::find_free(const int8_t* control,
+                                                                       size_t capacity, size_t hash) {
+  size_t group_mask = capacity / group_width - 1;
+  size_t group = (hash >> 7) & group_mask;
+  for (size_t step = 1;; ++step) {
+    uint32_t mask = match_free(control + group * group_width);
+    if (mask != 0) {
+      return group * group_width + std::countr_zero(mask);
+    }
+    group = (group + step) & group_mask;
+  }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+template<typename ...Args>
+size_t FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::emplace_new(size_t hash, Args&& ... args) {
+  if (static_cast<double>(sz + deleted + 1) > capacity * mx_load_factor) {
+    rehash(sz + 1 > capacity * mx_load_factor / 2 ? capacity * 2 : capacity);
+  }
+  size_t index = find_free(control, capacity, hash);
+  SlotAllocatorTraits::construct(slot_allocator, slots + index, std::forward<Args>(args)...);
+  if (control[index] == deleted_control) {
+    --deleted;
+  }
+  control[index] = static_cast<int8_t>(hash & 0x7F);
+  ++sz;
+  return index;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+void FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::allocate_arrays(size_t count,
+                                                                           int8_t*& new_control,
+                                                                           NodeType*& new_slots) {
+  new_slots = SlotAllocatorTraits::allocate(slot_allocator, count);
+  try {
+    new_control = ControlAllocatorTraits::allocate(control_allocator, count + 1);
+  } catch (...) {
+    SlotAllocatorTraits::deallocate(slot_allocator, new_slots, count);
+    throw;
+  }
+  std::fill(new_control, new_control + count, empty_control);
+  new_control[count] = sentinel_control;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+void FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::allocate(size_t count) {
+  allocate_arrays(count, control, slots);
+  capacity = count;
+  sz = 0;
+  deleted = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+void FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::release() {
+  if (capacity == 0) {
+    return;
+  }
+  for (size_t i = 0; i < capacity; ++i) {
+    if (control[i] >= 0) {
+      SlotAllocatorTraits::destroy(slot_allocator, slots + i);
+    }
+  }
+  SlotAllocatorTraits::deallocate(slot_allocator, slots, capacity);
+  ControlAllocatorTraits::deallocate(control_allocator, control, capacity + 1);
+  control = nullptr;
+  slots = nullptr;
+  capacity = 0;
+  sz = 0;
+  deleted = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+Value& FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::operator[](const Key& key) {
+  size_t hash = mix_hash(Hash{}(key));
+  size_t index = find_index(key, hash);
+  if (index == capacity) {
+    index = emplace_new(hash, std::piecewise_construct, std::forward_as_tuple(key),
+                        std::forward_as_tuple());
+  }
+  return slots[index].second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+Value& FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::operator[](Key&& key) {
+  size_t hash = mix_hash(Hash{}(key));
+  size_t index = find_index(key, hash);
+  if (index == capacity) {
+    index = emplace_new(hash, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                        std::forward_as_tuple());
+  }
+  return slots[index].second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+const Value& FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::at(const Key& key) const {
+  const_iterator iter = find(key);
+  if (iter == end()) {
+    throw std::out_of_range("");
+  }
+  return iter->second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+Value& FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::at(const Key& key) {
+  iterator iter = find(key);
+  if (iter == end()) {
+    throw std::out_of_range("");
+  }
+  return iter->second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+size_t FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::size() const {
+  return sz;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+size_t FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::bucket_count() const {
+  return capacity;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::begin() {
+  if (sz == 0) {
+    return end();
+  }
+  iterator iter(control, slots);
+  iter.skip_free();
+  return iter;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::const_iterator
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::begin() const {
+  if (sz == 0) {
+    return end();
+  }
+  const_iterator iter(control, slots);
+  iter.skip_free();
+  return iter;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+std::pair<typename FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator, bool>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::insert(const NodeType& object) {
+  size_t hash = mix_hash(Hash{}(object.first));
+  size_t index = find_index(object.first, hash);
+  if (index != capacity) {
+    return {iterator(control + index, slots + index), false};
+  }
+  index = emplace_new(hash, object);
+  return {iterator(control + index, slots + index), true};
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+std::pair<typename FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator, bool>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::insert(NodeType&& object) {
+  size_t hash = mix_hash(Hash{}(object.first));
+  size_t index = find_index(object.first, hash);
+  if (index != capacity) {
+    return {iterator(control + index, slots + index), false};
+  }
+  index = emplace_new(hash, std::move(object));
+  return {iterator(control + index, slots + index), true};
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+template<typename InputIterator>
+void
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::insert(InputIterator first, InputIterator last) {
+  for (; first != last; ++first) {
+    insert(*first);
+  }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+template<typename ...Args>
+std::pair<typename FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator, bool>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::emplace(Args&& ... args) {
+  NodeType object(std::forward<Args>(args)...);
+  return insert(std::move(object));
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+void FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::erase(iterator iter) {
+  size_t index = iter.control - control;
+  SlotAllocatorTraits::destroy(slot_allocator, slots + index);
+  if (match(control + index / group_width * group_width, empty_control) != 0) {
+    control[index] = empty_control;
+  } else {
+    control[index] = deleted_control;
+    ++deleted;
+  }
+  --sz;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+void FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::erase(iterator first, iterator last) {
+  while (first != last) {
+    erase(first++);
+  }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+void FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::clear() {
+  for (size_t i = 0; i < capacity; ++i) {
+    if (control[i] >= 0) {
+      SlotAllocatorTraits::destroy(slot_allocator, slots + i);
+    }
+  }
+  std::fill(control, control + capacity, empty_control);
+  sz = 0;
+  deleted = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::const_iterator
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::find(const Key& key) const {
+  size_t index = find_index(key, mix_hash(Hash{}(key)));
+  return const_iterator(control + index, slots + index);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::iterator
+FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::find(const Key& key) {
+  size_t index = find_index(key, mix_hash(Hash{}(key)));
+  return iterator(control + index, slots + index);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+void FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::reserve(size_t count) {
+  rehash(std::ceil(count / max_load_factor()));
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+double FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::max_load_factor() const {
+  return mx_load_factor;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+double FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::load_factor() const {
+  return capacity == 0 ? 0 : static_cast<double>(sz) / capacity;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+void FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::set_max_load_factor(double factor) {
+  mx_load_factor = std::min(factor, max_possible_load_factor);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+void FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::rehash(size_t count) {
+  count = std::max(count, static_cast<size_t>(std::ceil((sz + 1) / max_load_factor())));
+  size_t new_capacity = group_width;
+  while (new_capacity < count) {
+    new_capacity *= 2;
+  }
+
+  // Every hash is computed and every target slot claimed before any element is moved, so a
+  // throwing hash leaves the old slots untouched. The second pass only moves elements whose
+  // move cannot throw; otherwise it copies, and a throwing copy is rolled back.
+  int8_t* new_control;
+  NodeType* new_slots;
+  allocate_arrays(new_capacity, new_control, new_slots);
+  std::vector<size_t> targets;
+  size_t placed = 0;
+  try {
+    targets.resize(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+      if (control[i] >= 0) {
+        targets[i] = find_free(new_control, new_capacity, mix_hash(Hash{}(slots[i].first)));
+        new_control[targets[i]] = control[i];
+      }
+    }
+    for (; placed < capacity; ++placed) {
+      if (control[placed] >= 0) {
+        SlotAllocatorTraits::construct(slot_allocator, new_slots + targets[placed],
+                                       std::move_if_noexcept(slots[placed]));
+      }
+    }
+  } catch (...) {
+    for (size_t i = 0; i < placed; ++i) {
+      if (control[i] >= 0) {
+        SlotAllocatorTraits::destroy(slot_allocator, new_slots + targets[i]);
+      }
+    }
+    SlotAllocatorTraits::deallocate(slot_allocator, new_slots, new_capacity);
+    ControlAllocatorTraits::deallocate(control_allocator, new_control, new_capacity + 1);
+    throw;
+  }
+
+  size_t old_size = sz;
+  release();
+  control = new_control;
+  slots = new_slots;
+  capacity = new_capacity;
+  sz = old_size;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+template<bool is_const>
+class FlatUnorderedMap<Key, Value, Hash, Equal, Allocator>::common_iterator {
+  friend FlatUnorderedMap;
+
+  template<bool>
+  friend class common_iterator;
+
+  using Type = std::conditional_t<is_const, const ValueType, ValueType>;
+  using SlotType = std::conditional_t<is_const, const NodeType, NodeType>;
+
+  const int8_t* control;
+  SlotType* slot;
+
+  common_iterator(const int8_t* control, SlotType* slot) : control(control), slot(slot) {}
+
+  void skip_free() {
+    while (*control < sentinel_control) {
+      ++control;
+      ++slot;
+    }
+  }
+
+public:
+
+  using iterator_concept = std::bidirectional_iterator_tag;
+  using iterator_category = std::bidirectional_iterator_tag;
+  using difference_type = int;
+  using value_type = std::remove_cv_t<Type>;
+  using pointer = Type*;
+  using reference = Type&;
+
+  template<bool other_const>
+  requires(is_const || !other_const)
+  common_iterator(const common_iterator<other_const>& other) : control(other.control),
+                                                               slot(other.slot) {}
+
+  template<bool other_const>
+  requires(is_const || !other_const)
+  common_iterator& operator=(const common_iterator<other_const>& other) {
+    control = other.control;
+    slot = other.slot;
+    return *this;
+  }
+
+  Type& operator*() const {
+    return reinterpret_cast<Type&>(*slot);
+  }
+
+  Type* operator->() const {
+    return reinterpret_cast<Type*>(slot);
+  }
+
+  common_iterator& operator++() {
+    ++control;
+    ++slot;
+    skip_free();
+    return *this;
+  }
+
+  common_iterator& operator--() {
+    do {
+      --control;
+      --slot;
+    } while (*control < 0);
+    return *this;
+  }
+
+  common_iterator operator++(int) {
+    common_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  common_iterator operator--(int) {
+    common_iterator tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  bool operator==(const common_iterator& other) const {
+    return control == other.control;
+  }
+};
+
 #endif //CPP_UNORDERED_MAP_H